@@ -6,7 +6,7 @@
 
 std::map<std::string, boost::python::object> SimEntity::moduleMap;
 
-SimEntity::SimEntity(const std::string& type, const std::string& name, const std::string& filePath) : m_type(type), m_name(name) {
+SimEntity::SimEntity(const std::string& type, const std::string& filePath) {
 	boost::python::object main = boost::python::import("__main__");
 	boost::python::object globals = main.attr("__dict__");
 
@@ -30,3 +30,95 @@ void SimEntity::updatePhysics() {
 		PyErr_Print();
 	}
 }
+
+
+void SimEntity::saveState(std::string& state) {
+	state.clear();
+
+	if (!PyObject_HasAttrString(m_simEntity.ptr(), "getState")) {
+		return;
+	}
+
+	try {
+		boost::python::object bytes = m_simEntity.attr("getState")();
+
+		char* data;
+		Py_ssize_t size;
+
+		if (PyBytes_AsStringAndSize(bytes.ptr(), &data, &size) == 0) {
+			state.assign(data, size);
+		} else {
+			boost::python::throw_error_already_set();
+		}
+	} catch (const boost::python::error_already_set&) {
+		std::cerr << ">>> Error! Uncaught exception:\n";
+		PyErr_Print();
+	}
+}
+
+void SimEntity::restoreState(const std::string& state) {
+	if (!PyObject_HasAttrString(m_simEntity.ptr(), "setState")) {
+		return;
+	}
+
+	try {
+		boost::python::object bytes(boost::python::handle<>(PyBytes_FromStringAndSize(state.data(), state.size())));
+		m_simEntity.attr("setState")(bytes);
+	} catch (const boost::python::error_already_set&) {
+		std::cerr << ">>> Error! Uncaught exception:\n";
+		PyErr_Print();
+	}
+}
+
+bool SimEntity::position(double (&xyz)[3]) {
+	if (!PyObject_HasAttrString(m_simEntity.ptr(), "getPosition")) {
+		return false;
+	}
+
+	try {
+		boost::python::object pos = m_simEntity.attr("getPosition")();
+
+		for (int i = 0; i < 3; ++i) {
+			xyz[i] = boost::python::extract<double>(pos[i]);
+		}
+
+		return true;
+	} catch (const boost::python::error_already_set&) {
+		std::cerr << ">>> Error! Uncaught exception:\n";
+		PyErr_Print();
+	}
+
+	return false;
+}
+
+bool SimEntity::getProperty(const boost::python::object& name, double& value) {
+	if (!PyObject_HasAttrString(m_simEntity.ptr(), "getProperty")) {
+		return false;
+	}
+
+	try {
+		value = boost::python::extract<double>(m_simEntity.attr("getProperty")(name));
+		return true;
+	} catch (const boost::python::error_already_set&) {
+		std::cerr << ">>> Error! Uncaught exception:\n";
+		PyErr_Print();
+	}
+
+	return false;
+}
+
+bool SimEntity::setProperty(const boost::python::object& name, double value) {
+	if (!PyObject_HasAttrString(m_simEntity.ptr(), "setProperty")) {
+		return false;
+	}
+
+	try {
+		m_simEntity.attr("setProperty")(name, value);
+		return true;
+	} catch (const boost::python::error_already_set&) {
+		std::cerr << ">>> Error! Uncaught exception:\n";
+		PyErr_Print();
+	}
+
+	return false;
+}
\ No newline at end of file
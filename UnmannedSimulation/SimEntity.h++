@@ -3,16 +3,37 @@
 #include "stdafx.h"
 #include <map>
 
+// The script binding of an entity. Its name and type are held by sim::entities::registry. Copies
+// share the Python object; moves take it over.
 class SimEntity
 {
 public:
-	SimEntity(const std::string& type, const std::string& name, const std::string& filePath);
-	~SimEntity();
+	SimEntity(const std::string& type, const std::string& filePath);
+	SimEntity(const SimEntity&) = default;
+	SimEntity(SimEntity&&) = default;
+	virtual ~SimEntity();
+
+	SimEntity& operator=(const SimEntity&) = default;
+	SimEntity& operator=(SimEntity&&) = default;
 
 	virtual void updatePhysics();
 
-	const std::string m_type;
-	const std::string m_name;
+	// Compact snapshot of the entity's state, used for replay keyframes. Entities whose script
+	// defines `getState()` (returning bytes) and `setState(bytes)` are snapshotted through them;
+	// the others are treated as stateless.
+	virtual void saveState(std::string& state);
+	virtual void restoreState(const std::string& state);
+
+	// Position of the entity, for proximity queries. Entities whose script defines `getPosition()`
+	// (returning an (x, y, z) sequence) fill `xyz`; for the others this returns false.
+	virtual bool position(double (&xyz)[3]);
+
+	// Named numeric properties, for property sessions. Entities whose script defines
+	// `getProperty(name)` (returning a number) and `setProperty(name, value)` expose them; `name` is
+	// a Python str, kept by the caller so that it is not created again on every access. Both return
+	// false if the entity has no such hook or the script raised.
+	virtual bool getProperty(const boost::python::object& name, double& value);
+	virtual bool setProperty(const boost::python::object& name, double value);
 
 protected:
 	boost::python::object m_simEntity;
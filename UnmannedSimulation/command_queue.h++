@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "message_types.h++"
+
+namespace sim {
+	namespace networking {
+
+		///
+		/// An inbound client command, as read off a connection
+		///
+
+		struct command {
+			sim::message::message_type type;
+			std::vector<uint8_t>       data;
+		};
+
+		///
+		/// Hands inbound commands from the IO thread to the simulation loop.
+		///
+		/// Connections push commands as they arrive; the simulation loop drains the queue once at the
+		/// start of every frame, so that a command always takes effect on a frame boundary and can be
+		/// journaled against that frame number.
+		///
+
+		class command_queue {
+			public:
+				void push(command&& cmd) {
+					std::lock_guard<std::mutex> lock(m_mutex);
+					m_pending.push_back(std::move(cmd));
+				}
+
+				// Moves every queued command into `out`, replacing its contents.
+				void drain(std::vector<command>& out) {
+					out.clear();
+
+					std::lock_guard<std::mutex> lock(m_mutex);
+					m_pending.swap(out);
+				}
+
+			private:
+				std::mutex           m_mutex;
+				std::vector<command> m_pending;
+		};
+	}
+}
@@ -1,23 +1,35 @@
 #pragma once
 
+#include <deque>
+#include <memory>
+
+#include <boost/asio/post.hpp>
 #include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
 #include <boost/asio/completion_condition.hpp>
 #include <boost/bind.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/enable_shared_from_this.hpp>
 
-#include "message_handler.h++"
+#include <jsbsim/input_output/FGPropertyProtocol.h>
+
+#include "command_queue.h++"
 #include "message_types.h++"
+#include "telemetry.h++"
 
+// A client connection. A connection that opens with a property protocol HELLO carries a property
+// session: its stream is split into messages, each queued as an MT_PROPERTY_SESSION command tagged
+// with the connection's session id, and the simulation writes replies back through send(). Any other
+// connection is passed on as raw MT_SIM_ENTITY_INFO data, as it always was.
 class tcp_connection :
 	public boost::enable_shared_from_this<tcp_connection>
 {
 public:
 	typedef boost::shared_ptr<tcp_connection> pointer;
 
-	static pointer create(boost::asio::io_service& io_service)
+	static pointer create(boost::asio::io_service& io_service, sim::networking::command_queue& commands, uint32_t session)
 	{
-		return pointer(new tcp_connection(io_service));
+		return pointer(new tcp_connection(io_service, commands, session));
 	}
 
 	boost::asio::ip::tcp::socket& socket()
@@ -25,6 +37,11 @@ public:
 		return m_socket;
 	}
 
+	uint32_t session() const
+	{
+		return m_session;
+	}
+
 	void start()
 	{
 		boost::asio::async_read(
@@ -35,38 +52,168 @@ public:
 		);
 	}
 
+	// Queues bytes for the client. Safe to call from any thread: the write is started on the IO thread.
+	void send(std::vector<uint8_t>&& bytes)
+	{
+		auto data = std::make_shared<std::vector<uint8_t>>(std::move(bytes));
+		auto self = shared_from_this();
+
+		boost::asio::post(m_socket.get_executor(), [self, data]() {
+			self->queue_write(std::move(*data));
+		});
+	}
+
 private:
-	tcp_connection(boost::asio::io_service& io_service)
+	enum class stream_mode { SM_SNIFFING, SM_LEGACY, SM_PROPERTY_SESSION };
+
+	typedef JSBSim::FGPropertyProtocol property_protocol;
+
+	// A client that has this many writes outstanding is not reading what it is sent, and is dropped.
+	static const std::size_t max_pending_writes = 256;
+
+	tcp_connection(boost::asio::io_service& io_service, sim::networking::command_queue& commands, uint32_t session)
 		: m_socket(io_service)
+		, m_commands(commands)
+		, m_session(session)
+		, m_mode(stream_mode::SM_SNIFFING)
 	{
 	}
 
-	void handle_write(const boost::system::error_code& /*error*/,
+	void queue_write(std::vector<uint8_t>&& bytes)
+	{
+		if (!m_socket.is_open()) {
+			return;
+		}
+
+		if (m_writes.size() >= max_pending_writes) {
+			SIM_WARN(sim::telemetry::event::EV_CONNECTION_STALLED, m_session);
+			m_socket.close();
+			return;
+		}
+
+		m_writes.push_back(std::move(bytes));
+
+		if (m_writes.size() == 1) {
+			write_next();
+		}
+	}
+
+	void write_next()
+	{
+		boost::asio::async_write(
+			m_socket,
+			boost::asio::buffer(m_writes.front()),
+			boost::bind(&tcp_connection::handle_write, shared_from_this(), boost::asio::placeholders::error, boost::asio::placeholders::bytes_transferred)
+		);
+	}
+
+	void handle_write(const boost::system::error_code& error,
 		size_t /*bytes_transferred*/)
 	{
+		// A failed write is followed by a failed read, which closes the connection.
+		if (error) {
+			m_writes.clear();
+			return;
+		}
+
+		m_writes.pop_front();
+
+		if (!m_writes.empty()) {
+			write_next();
+		}
+	}
+
+	// Decides what the connection carries once its first bytes are in: a property session opens with
+	// a HELLO, i.e. a 5 byte payload of type 0 starting with the protocol's magic.
+	stream_mode sniff() const
+	{
+		const uint8_t hello[] = {
+			5, 0, property_protocol::mtHello,
+			property_protocol::Magic & 0xff, (property_protocol::Magic >> 8) & 0xff,
+			(property_protocol::Magic >> 16) & 0xff, (property_protocol::Magic >> 24) & 0xff
+		};
+
+		const uint8_t* data = boost::asio::buffer_cast<const uint8_t*>(m_message.data());
+		std::size_t size = std::min(m_message.size(), sizeof hello);
+
+		if (!std::equal(data, data + size, hello)) {
+			return stream_mode::SM_LEGACY;
+		}
+
+		return size == sizeof hello ? stream_mode::SM_PROPERTY_SESSION : stream_mode::SM_SNIFFING;
 	}
 
-	void handle_read(const boost::system::error_code& error, size_t bytes_transferred)
+	// Queues every complete message in the buffer, leaving a partial one for the next read.
+	void push_messages()
 	{
-		std::cout << "Handle Read of connection\n";
+		const uint8_t* data = boost::asio::buffer_cast<const uint8_t*>(m_message.data());
+		std::size_t size = m_message.size();
+		std::size_t used = 0;
+
+		while (std::size_t length = property_protocol::FrameLength(data + used, size - used)) {
+			push_message(data + used, length);
+			used += length;
+		}
 
+		m_message.consume(used);
+	}
+
+	void push_message(const uint8_t* message, std::size_t length)
+	{
+		std::vector<uint8_t> target;
+		target.reserve(4 + length);
+
+		for (int shift = 0; shift < 32; shift += 8) {
+			target.push_back(static_cast<uint8_t>(m_session >> shift));
+		}
+
+		target.insert(target.end(), message, message + length);
+
+		m_commands.push({ sim::message::message_type::MT_PROPERTY_SESSION, std::move(target) });
+	}
+
+	void handle_read(const boost::system::error_code& error, size_t bytes_transferred)
+	{
 		if (!error)
 		{
-			std::vector<uint8_t> target(m_message.size());
-			buffer_copy(boost::asio::buffer(target), m_message.data());
+			SIM_TRACE(sim::telemetry::event::EV_PACKET_READ, m_session, bytes_transferred);
+			sim::telemetry::count(sim::telemetry::counter::CT_PACKETS_READ);
+			sim::telemetry::count(sim::telemetry::counter::CT_BYTES_READ, bytes_transferred);
+
+			if (m_mode == stream_mode::SM_SNIFFING) {
+				m_mode = sniff();
+			}
 
-			m_message.consume(bytes_transferred);
+			// Commands are not processed here, on the IO thread, but queued for the simulation loop to
+			// apply at the start of its next frame.
+			if (m_mode == stream_mode::SM_PROPERTY_SESSION) {
+				push_messages();
+			} else if (m_mode == stream_mode::SM_LEGACY) {
+				std::vector<uint8_t> target(m_message.size());
+				buffer_copy(boost::asio::buffer(target), m_message.data());
 
-			m_message_handler.process_message(sim::message::message_type::MT_SIM_ENTITY_INFO, target);
+				m_message.consume(target.size());
+
+				m_commands.push({ sim::message::message_type::MT_SIM_ENTITY_INFO, std::move(target) });
+			}
 
 			start();
 		}
 		else
 		{
-			if (error.value() == boost::asio::error::connection_reset) {
-				std::cout << "Connection closed." << std::endl;
+			// A client hanging up, cleanly or not, is not an error. Otherwise the code is logged as a
+			// number, with its category as the text: a message would not fit in a record.
+			if (error == boost::asio::error::eof || error == boost::asio::error::connection_reset) {
+				SIM_INFO(sim::telemetry::event::EV_CONNECTION_CLOSED, m_session);
 			} else {
-				std::cout << "Connection error: " << error.message() << std::endl;
+				SIM_WARN(sim::telemetry::event::EV_CONNECTION_ERROR, m_session, error.value(), error.category().name());
+			}
+
+			// The session ends with its connection; the simulation learns of it in frame order, like
+			// of any other command.
+			if (m_mode == stream_mode::SM_PROPERTY_SESSION) {
+				const uint8_t bye[] = { 0, 0, property_protocol::mtBye };
+				push_message(bye, sizeof bye);
 			}
 
 			m_socket.close();
@@ -75,5 +222,8 @@ private:
 
 	boost::asio::ip::tcp::socket m_socket;
 	boost::asio::streambuf m_message;
-	sim::networking::message_handler m_message_handler;
+	sim::networking::command_queue& m_commands;
+	uint32_t m_session;
+	stream_mode m_mode;
+	std::deque<std::vector<uint8_t>> m_writes;
 };
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "stdafx.h"
+
+#include "entity_registry.h++"
+
+namespace sim {
+	namespace entities {
+
+		namespace {
+			// Marks a slot that holds no entity.
+			const uint32_t free_slot = 0xffffffffu;
+		}
+
+		registry::registry() { }
+
+		registry::~registry() { }
+
+		void registry::reserve(std::size_t capacity) {
+			m_slots.reserve(capacity);
+			m_freeSlots.reserve(capacity);
+			m_handles.reserve(capacity);
+			m_names.reserve(capacity);
+			m_types.reserve(capacity);
+			m_scripts.reserve(capacity);
+			m_nameIndex.reserve(capacity);
+		}
+
+		uint32_t registry::intern_type(const std::string& type) {
+			auto found = m_typeIndex.find(type);
+
+			if (found != m_typeIndex.end()) {
+				return found->second;
+			}
+
+			uint32_t id = static_cast<uint32_t>(m_typeNames.size());
+			m_typeNames.push_back(type);
+			m_typeIndex.emplace(type, id);
+			return id;
+		}
+
+		entity_handle registry::spawn(const std::string& type, const std::string& name, const std::string& scriptPath) {
+			if (m_nameIndex.find(name) != m_nameIndex.end()) {
+				std::cerr << "An entity named " << name << " already exists." << std::endl;
+				return invalid_entity;
+			}
+
+			// Build the script binding first: if the script throws, nothing has been touched yet.
+			std::unique_ptr<SimEntity> script(new SimEntity(type, scriptPath));
+
+			uint32_t index;
+
+			if (!m_freeSlots.empty()) {
+				index = m_freeSlots.back();
+				m_freeSlots.pop_back();
+			} else {
+				index = static_cast<uint32_t>(m_slots.size());
+				m_slots.push_back(slot{ free_slot, 1 });
+			}
+
+			slot& s = m_slots[index];
+			s.dense = static_cast<uint32_t>(m_handles.size());
+
+			entity_handle handle{ index, s.generation };
+
+			m_handles.push_back(handle);
+			m_names.push_back(name);
+			m_types.push_back(intern_type(type));
+			m_scripts.push_back(std::move(script));
+
+			m_nameIndex.emplace(name, handle);
+
+			return handle;
+		}
+
+		bool registry::destroy(entity_handle handle) {
+			if (!valid(handle)) {
+				return false;
+			}
+
+			slot& s = m_slots[handle.index];
+			uint32_t hole = s.dense;
+			uint32_t last = static_cast<uint32_t>(m_handles.size() - 1);
+
+			m_nameIndex.erase(m_names[hole]);
+
+			// Fill the hole with the last entity so that the dense arrays stay packed.
+			if (hole != last) {
+				m_handles[hole] = m_handles[last];
+				m_names[hole].swap(m_names[last]);
+				m_types[hole] = m_types[last];
+				m_scripts[hole] = std::move(m_scripts[last]);
+
+				m_slots[m_handles[hole].index].dense = hole;
+			}
+
+			m_handles.pop_back();
+			m_names.pop_back();
+			m_types.pop_back();
+			m_scripts.pop_back();
+
+			s.dense = free_slot;
+
+			// Generation 0 is reserved for invalid_entity.
+			if (++s.generation == 0) {
+				s.generation = 1;
+			}
+
+			m_freeSlots.push_back(handle.index);
+
+			return true;
+		}
+
+		bool registry::valid(entity_handle handle) const {
+			return handle.index < m_slots.size()
+				&& m_slots[handle.index].generation == handle.generation
+				&& m_slots[handle.index].dense != free_slot;
+		}
+
+		entity_handle registry::find(const std::string& name) const {
+			auto found = m_nameIndex.find(name);
+			return found != m_nameIndex.end() ? found->second : invalid_entity;
+		}
+
+		void registry::update_physics() {
+			for (auto& script : m_scripts) {
+				script->updatePhysics();
+			}
+		}
+	}
+}
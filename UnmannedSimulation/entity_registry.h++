@@ -0,0 +1,121 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SimEntity.h++"
+
+namespace sim {
+	namespace entities {
+
+		///
+		/// Generational entity handle.
+		///
+		/// `index` names a slot of the registry and `generation` the occupant of that slot: destroying
+		/// an entity bumps its slot's generation, so stale handles to it stop resolving even once the
+		/// slot is reused. A handle packs into 64 bits for the wire and the replay journal.
+		///
+
+		struct entity_handle {
+			uint32_t index;
+			uint32_t generation;
+
+			uint64_t value() const { return (uint64_t(generation) << 32) | index; }
+
+			static entity_handle from_value(uint64_t value) {
+				return entity_handle{ uint32_t(value & 0xffffffffu), uint32_t(value >> 32) };
+			}
+
+			bool operator==(const entity_handle& other) const { return index == other.index && generation == other.generation; }
+			bool operator!=(const entity_handle& other) const { return !(*this == other); }
+		};
+
+		// Never returned by spawn(): generations start at 1.
+		const entity_handle invalid_entity = { 0, 0 };
+
+		///
+		/// Owns every simulation entity.
+		///
+		/// Components are kept in dense, parallel arrays indexed by a dense position, so that the
+		/// per-frame passes walk contiguous arrays instead of a tree of separately allocated entities.
+		/// A sparse slot array maps handle indices to dense positions. Spawning takes a slot from the
+		/// free list (or appends one) and appends to the dense arrays; destroying swaps the last
+		/// entity into the hole. Both are O(1), and the arrays themselves only ever grow to the peak
+		/// population. Each entity still allocates its name, its name index node, its script binding
+		/// and the Python object behind it.
+		///
+		/// Script bindings are held by pointer, so that a SimEntity subclass keeps its overrides.
+		///
+		/// Names are only resolved at the protocol boundary, through a hash index; everything else
+		/// holds handles. Type names are interned, so entities carry a small type id.
+		///
+
+		class registry {
+			public:
+				registry();
+				virtual ~registry();
+
+				// Pre-sizes every array for `capacity` live entities.
+				void reserve(std::size_t capacity);
+
+				// Creates an entity, loading its script on first use of `type`. Returns invalid_entity if
+				// `name` is already taken.
+				entity_handle spawn(const std::string& type, const std::string& name, const std::string& scriptPath);
+
+				// Destroys an entity. Returns false if the handle is stale.
+				bool destroy(entity_handle handle);
+
+				bool valid(entity_handle handle) const;
+
+				// Name lookup, for the protocol boundary. Returns invalid_entity if there is no such entity.
+				entity_handle find(const std::string& name) const;
+
+				std::size_t size() const { return m_handles.size(); }
+
+				// Runs every entity's physics step, in dense order.
+				void update_physics();
+
+				// Component access by handle. The handle must be valid.
+				const std::string& name(entity_handle handle) const    { return m_names[dense(handle)]; }
+				const std::string& type_name(entity_handle handle) const { return m_typeNames[m_types[dense(handle)]]; }
+				SimEntity&         script(entity_handle handle)         { return *m_scripts[dense(handle)]; }
+
+				// Dense arrays, for linear passes over all entities. Position i of each array belongs to
+				// the entity handles()[i].
+				const std::vector<entity_handle>& handles() const { return m_handles; }
+				const std::vector<std::string>&   names() const   { return m_names; }
+				const std::vector<uint32_t>&      types() const   { return m_types; }
+				SimEntity&                        script_at(std::size_t i) { return *m_scripts[i]; }
+
+				const std::string& type_name_of(uint32_t type) const { return m_typeNames[type]; }
+
+			private:
+				struct slot {
+					uint32_t dense;
+					uint32_t generation;
+				};
+
+				uint32_t dense(entity_handle handle) const { return m_slots[handle.index].dense; }
+				uint32_t intern_type(const std::string& type);
+
+				// Sparse side
+				std::vector<slot>     m_slots;
+				std::vector<uint32_t> m_freeSlots;
+
+				// Dense side, one entry per live entity
+				std::vector<entity_handle> m_handles;
+				std::vector<std::string>   m_names;
+				std::vector<uint32_t>      m_types;
+				std::vector<std::unique_ptr<SimEntity>> m_scripts;
+
+				std::unordered_map<std::string, entity_handle> m_nameIndex;
+				std::vector<std::string>                       m_typeNames;
+				std::unordered_map<std::string, uint32_t>      m_typeIndex;
+		};
+	}
+}
@@ -0,0 +1,192 @@
+#include "stdafx.h"
+
+#include "journal.h++"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <experimental/filesystem>
+
+namespace sim {
+	namespace replay {
+
+		namespace {
+			const char journal_magic[8] = { 'S', 'I', 'M', 'J', 'R', 'N', 'L', '2' };
+
+			struct file_header {
+				char     magic[8];
+				uint64_t end;
+				uint64_t frames;     // frames completed, counting from frame 0
+			};
+
+			struct record_header {
+				uint32_t kind;
+				uint32_t size;
+				uint64_t frame;
+			};
+
+			std::size_t aligned(std::size_t n) {
+				return (n + 7) & ~std::size_t(7);
+			}
+		}
+
+		// journal_writer
+		journal_writer::journal_writer(const std::string& path, std::size_t chunk_size) :
+			m_path(path),
+			m_chunkSize(std::max<std::size_t>(aligned(chunk_size), sizeof(file_header))),
+			m_capacity(0),
+			m_end(sizeof(file_header)) {
+
+			// Create (or truncate) the file; it has to exist before it can be mapped.
+			std::ofstream(path, std::ios::binary | std::ios::trunc);
+
+			map(m_chunkSize);
+
+			file_header* header = static_cast<file_header*>(m_region.get_address());
+			std::memcpy(header->magic, journal_magic, sizeof(journal_magic));
+			header->end = m_end;
+			header->frames = 0;
+		}
+
+		journal_writer::~journal_writer() {
+			try {
+				m_region.flush();
+				boost::interprocess::mapped_region().swap(m_region);
+				std::experimental::filesystem::resize_file(m_path, m_end);
+			} catch (const std::exception& e) {
+				std::cerr << "Could not close journal " << m_path << ": " << e.what() << std::endl;
+			}
+		}
+
+		void journal_writer::map(std::size_t capacity) {
+			boost::interprocess::mapped_region().swap(m_region);
+
+			std::experimental::filesystem::resize_file(m_path, capacity);
+
+			boost::interprocess::file_mapping(m_path.c_str(), boost::interprocess::read_write).swap(m_mapping);
+			boost::interprocess::mapped_region(m_mapping, boost::interprocess::read_write).swap(m_region);
+
+			m_capacity = capacity;
+		}
+
+		void journal_writer::append(record_kind kind, uint64_t frame, const void* data, uint32_t size) {
+			std::size_t needed = sizeof(record_header) + aligned(size);
+
+			if (m_end + needed > m_capacity) {
+				map(m_capacity + std::max(m_chunkSize, aligned(needed)));
+			}
+
+			uint8_t* base = static_cast<uint8_t*>(m_region.get_address());
+
+			record_header* header = reinterpret_cast<record_header*>(base + m_end);
+			header->kind  = static_cast<uint32_t>(kind);
+			header->size  = size;
+			header->frame = frame;
+
+			if (size > 0) {
+				std::memcpy(base + m_end + sizeof(record_header), data, size);
+			}
+
+			// Publish the record only once it is complete.
+			m_end += needed;
+			reinterpret_cast<file_header*>(base)->end = m_end;
+		}
+
+		void journal_writer::end_frame(uint64_t frame) {
+			reinterpret_cast<file_header*>(m_region.get_address())->frames = frame + 1;
+		}
+
+		// journal_reader
+		journal_reader::journal_reader(const std::string& path) :
+			m_mapping(path.c_str(), boost::interprocess::read_only),
+			m_region(m_mapping, boost::interprocess::read_only),
+			m_base(static_cast<const uint8_t*>(m_region.get_address())),
+			m_end(0),
+			m_cursor(sizeof(file_header)),
+			m_lastFrame(0) {
+
+			const file_header* header = reinterpret_cast<const file_header*>(m_base);
+
+			if (m_region.get_size() < sizeof(file_header) || std::memcmp(header->magic, journal_magic, sizeof(journal_magic)) != 0) {
+				throw std::runtime_error(path + " is not a simulation journal");
+			}
+
+			m_end = std::min<std::size_t>(header->end, m_region.get_size());
+
+			// Index the keyframes so that seeking does not have to scan the journal.
+			record rec;
+			std::size_t offset = sizeof(file_header);
+			std::size_t next;
+
+			while (read_at(offset, rec, next)) {
+				if (rec.kind == record_kind::RK_KEYFRAME) {
+					m_keyframeFrames.push_back(rec.frame);
+					m_keyframeOffsets.push_back(offset);
+				}
+
+				m_lastFrame = rec.frame;
+				offset = next;
+			}
+
+			// Frames without records still ran: the journal covers every frame it saw completed.
+			if (header->frames > 0) {
+				m_lastFrame = std::max<uint64_t>(m_lastFrame, header->frames - 1);
+			}
+		}
+
+		journal_reader::~journal_reader() { }
+
+		bool journal_reader::read_at(std::size_t offset, record& out, std::size_t& next) const {
+			if (offset + sizeof(record_header) > m_end) {
+				return false;
+			}
+
+			const record_header* header = reinterpret_cast<const record_header*>(m_base + offset);
+
+			next = offset + sizeof(record_header) + aligned(header->size);
+
+			if (next > m_end) {
+				return false;
+			}
+
+			out.kind  = static_cast<record_kind>(header->kind);
+			out.frame = header->frame;
+			out.data  = m_base + offset + sizeof(record_header);
+			out.size  = header->size;
+
+			return true;
+		}
+
+		bool journal_reader::next(record& out) {
+			std::size_t next;
+
+			if (!read_at(m_cursor, out, next)) {
+				return false;
+			}
+
+			m_cursor = next;
+			return true;
+		}
+
+		bool journal_reader::peek(record& out) const {
+			std::size_t next;
+			return read_at(m_cursor, out, next);
+		}
+
+		void journal_reader::rewind() {
+			m_cursor = sizeof(file_header);
+		}
+
+		bool journal_reader::seek(uint64_t frame) {
+			auto it = std::upper_bound(m_keyframeFrames.begin(), m_keyframeFrames.end(), frame);
+
+			if (it == m_keyframeFrames.begin()) {
+				return false;
+			}
+
+			m_cursor = m_keyframeOffsets[(it - m_keyframeFrames.begin()) - 1];
+			return true;
+		}
+	}
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace sim {
+	namespace replay {
+
+		///
+		/// Journal record kinds
+		///
+
+		enum class record_kind : uint32_t
+		{
+			RK_INVALID = 0,
+			RK_COMMAND,
+			RK_KEYFRAME,
+			RK_INVALID_OUT_OF_RANGE
+		};
+
+		///
+		/// A record as read back from a journal. `data` points into the mapped file and stays valid for
+		/// as long as the reader that returned it.
+		///
+
+		struct record {
+			record_kind    kind;
+			uint64_t       frame;
+			const uint8_t* data;
+			uint32_t       size;
+		};
+
+		///
+		/// Append-only, memory-mapped journal file.
+		///
+		/// The file starts with a small header holding a magic number, the offset of the end of the last
+		/// complete record and the number of frames completed; records follow, each an 8 byte aligned header (kind, payload size, sim
+		/// frame) and its payload. The end offset is only advanced once a record has been fully written,
+		/// so a journal left behind by a crashed process reads back up to its last complete record.
+		///
+		/// Appending is a copy into the mapping; the file is grown (and remapped) a chunk at a time and
+		/// trimmed to its used size when the writer is destroyed.
+		///
+
+		class journal_writer {
+			public:
+				journal_writer(const std::string& path, std::size_t chunk_size = 16 * 1024 * 1024);
+				virtual ~journal_writer();
+
+				void append(record_kind kind, uint64_t frame, const void* data, uint32_t size);
+
+				// Marks `frame` as completed. Most frames have no records, so this is what tells a reader
+				// how far the run went.
+				void end_frame(uint64_t frame);
+
+				// Number of bytes used in the file, header included.
+				std::size_t size() const { return m_end; }
+
+			private:
+				journal_writer(const journal_writer&) = delete;
+				journal_writer& operator=(const journal_writer&) = delete;
+
+				void map(std::size_t capacity);
+
+				std::string                         m_path;
+				std::size_t                         m_chunkSize;
+				std::size_t                         m_capacity;
+				std::size_t                         m_end;
+				boost::interprocess::file_mapping   m_mapping;
+				boost::interprocess::mapped_region  m_region;
+		};
+
+		///
+		/// Sequential reader over a journal written by journal_writer, with random access to keyframes.
+		///
+
+		class journal_reader {
+			public:
+				explicit journal_reader(const std::string& path);
+				virtual ~journal_reader();
+
+				// Reads the record under the cursor and advances past it. Returns false at the end of the
+				// journal.
+				bool next(record& out);
+
+				// Returns the record under the cursor without advancing.
+				bool peek(record& out) const;
+
+				void rewind();
+
+				// Moves the cursor to the last keyframe at or before `frame`. Returns false, leaving the
+				// cursor where it was, if there is no such keyframe.
+				bool seek(uint64_t frame);
+
+				// The frames of all keyframes in the journal, in order.
+				const std::vector<uint64_t>& keyframes() const { return m_keyframeFrames; }
+
+				// The last frame the journal covers: the last completed frame, or the frame of the last
+				// record if that is later.
+				uint64_t last_frame() const { return m_lastFrame; }
+
+			private:
+				journal_reader(const journal_reader&) = delete;
+				journal_reader& operator=(const journal_reader&) = delete;
+
+				bool read_at(std::size_t offset, record& out, std::size_t& next) const;
+
+				boost::interprocess::file_mapping   m_mapping;
+				boost::interprocess::mapped_region  m_region;
+				const uint8_t*                      m_base;
+				std::size_t                         m_end;
+				std::size_t                         m_cursor;
+				std::vector<uint64_t>               m_keyframeFrames;
+				std::vector<std::size_t>            m_keyframeOffsets;
+				uint64_t                            m_lastFrame;
+		};
+	}
+}
@@ -286,6 +286,9 @@ private:
     bool got_wire;
 
     bool crashed;
+    // Receives the FDM messages after each update. It is reused, so that
+    // draining the queue does not allocate.
+    JSBSim::FGJSBBase::Message message;
 
     void do_trim(void);
 
@@ -364,6 +364,7 @@ FGJSBsim::FGJSBsim(double dt)
 	last_hook_root[0] = 0; last_hook_root[1] = 0; last_hook_root[2] = 0;
 
 	crashed = false;
+	message.text.reserve(128);
 }
 
 /******************************************************************************/
@@ -547,22 +548,21 @@ void FGJSBsim::update(double dt)
 		update_external_forces(fdmex->GetSimTime() + i * fdmex->GetDeltaT());
 	}
 
-	FGJSBBase::Message* msg;
-	while ((msg = fdmex->ProcessNextMessage()) != NULL) {
-		switch (msg->type) {
+	while (fdmex->ProcessNextMessage(message)) {
+		switch (message.type) {
 			case FGJSBBase::Message::eText:
-				if (msg->text == "Crash Detected: Simulation FREEZE.")
+				if (message.text == "Crash Detected: Simulation FREEZE.")
 					crashed = true;
-				SG_LOG(SG_FLIGHT, SG_INFO, msg->messageId << ": " << msg->text);
+				SG_LOG(SG_FLIGHT, SG_INFO, message.messageId << ": " << message.text);
 				break;
 			case FGJSBBase::Message::eBool:
-				SG_LOG(SG_FLIGHT, SG_INFO, msg->messageId << ": " << msg->text << " " << msg->bVal);
+				SG_LOG(SG_FLIGHT, SG_INFO, message.messageId << ": " << message.text << " " << message.bVal);
 				break;
 			case FGJSBBase::Message::eInteger:
-				SG_LOG(SG_FLIGHT, SG_INFO, msg->messageId << ": " << msg->text << " " << msg->iVal);
+				SG_LOG(SG_FLIGHT, SG_INFO, message.messageId << ": " << message.text << " " << message.iVal);
 				break;
 			case FGJSBBase::Message::eDouble:
-				SG_LOG(SG_FLIGHT, SG_INFO, msg->messageId << ": " << msg->text << " " << msg->dVal);
+				SG_LOG(SG_FLIGHT, SG_INFO, message.messageId << ": " << message.text << " " << message.dVal);
 				break;
 			default:
 				SG_LOG(SG_FLIGHT, SG_INFO, "Unrecognized message type.");
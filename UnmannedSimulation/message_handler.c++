@@ -4,14 +4,28 @@
 
 #include <google/protobuf/message.h>
 
+#include "telemetry.h++"
+
 namespace sim {
 	namespace networking {
-		message_handler::message_handler() { }
+		message_handler::message_handler(property_store& properties) :
+			m_sessions(properties) { }
 
 		message_handler::~message_handler() { }
 
 		void message_handler::process_message(sim::message::message_type msg_type, std::vector<uint8_t> packet_data) {
-			std::cout << "process_message called: " << std::string(packet_data.begin(), packet_data.end()) << std::endl;
+			if (msg_type == sim::message::message_type::MT_PROPERTY_SESSION) {
+				if (packet_data.size() < 4) {
+					return;
+				}
+
+				uint32_t session = packet_data[0] | (packet_data[1] << 8) | (packet_data[2] << 16) | (uint32_t(packet_data[3]) << 24);
+				m_sessions.process(session, packet_data.data() + 4, packet_data.size() - 4);
+				return;
+			}
+
+			SIM_DEBUG(sim::telemetry::event::EV_LEGACY_MESSAGE,
+				sim::telemetry::text_ref{ reinterpret_cast<const char*>(packet_data.data()), packet_data.size() }, packet_data.size());
 		}
 	}
 }
@@ -1,15 +1,21 @@
 #pragma once
 
 #include "message_types.h++"
+#include "property_sessions.h++"
 
 namespace sim {
 	namespace networking {
 		class message_handler {
 			public:
-				message_handler();
+				explicit message_handler(property_store& properties);
 				virtual ~message_handler();
 
 				void process_message(sim::message::message_type msg_type, std::vector<uint8_t> packet_data);
+
+				property_sessions& sessions() { return m_sessions; }
+
+			private:
+				property_sessions m_sessions;
 		};
 	}
 }
\ No newline at end of file
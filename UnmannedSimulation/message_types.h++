@@ -11,6 +11,7 @@ namespace sim {
 		{
 			MT_INVALID = 0,
 			MT_SIM_ENTITY_INFO,
+			MT_PROPERTY_SESSION,   // u32 session id, then one framed property protocol message
 			MT_INVALID_OUT_OF_RANGE
 		};
 
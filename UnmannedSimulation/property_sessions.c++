@@ -0,0 +1,408 @@
+#include "stdafx.h"
+
+#include "property_sessions.h++"
+
+#include <cmath>
+
+#include "telemetry.h++"
+
+namespace sim {
+	namespace networking {
+
+		namespace {
+			// Sessions are served over TCP, where an update is only limited by the u16 payload length.
+			const std::size_t max_update_entries =
+				(property_protocol::MaxPayload - property_protocol::UpdateHeaderSize) / property_protocol::UpdateEntrySize;
+		}
+
+		// entity_properties
+		bool entity_properties::resolve(const std::string& entity, const std::string& property, property_ref& ref) {
+			sim::entities::entity_handle handle = m_entities.find(entity);
+
+			if (!m_entities.valid(handle)) {
+				return false;
+			}
+
+			property_ref resolved;
+			resolved.entity = handle.value();
+			resolved.key = boost::python::str(property);
+
+			// Only properties the script answers for are resolved.
+			double value;
+
+			if (!get(resolved, value)) {
+				return false;
+			}
+
+			ref = resolved;
+			return true;
+		}
+
+		bool entity_properties::valid(const property_ref& ref) const {
+			return m_entities.valid(sim::entities::entity_handle::from_value(ref.entity));
+		}
+
+		bool entity_properties::get(const property_ref& ref, double& value) {
+			sim::entities::entity_handle entity = sim::entities::entity_handle::from_value(ref.entity);
+			return m_entities.valid(entity) && m_entities.script(entity).getProperty(ref.key, value);
+		}
+
+		bool entity_properties::set(const property_ref& ref, double value) {
+			sim::entities::entity_handle entity = sim::entities::entity_handle::from_value(ref.entity);
+			return m_entities.valid(entity) && m_entities.script(entity).setProperty(ref.key, value);
+		}
+
+		// property_sessions
+		property_sessions::property_sessions(property_store& store) :
+			m_store(store),
+			m_now(0.0) { }
+
+		property_sessions::~property_sessions() { }
+
+		void property_sessions::process(uint32_t session_id, const uint8_t* message, std::size_t size) {
+			std::size_t length = property_protocol::FrameLength(message, size);
+
+			if (length == 0) {
+				SIM_WARN(sim::telemetry::event::EV_SESSION_TRUNCATED, session_id);
+				return;
+			}
+
+			uint8_t type = message[2];
+			property_protocol::Reader in(message + property_protocol::HeaderSize, length - property_protocol::HeaderSize);
+
+			auto found = m_sessions.find(session_id);
+
+			if (type == property_protocol::mtHello) {
+				uint32_t magic = in.U32();
+				uint8_t version = in.U8();
+
+				if (!in.Good() || magic != property_protocol::Magic || version != property_protocol::Version) {
+					// The session is not opened, or is closed if it was: with no session left to flush it,
+					// the error is sent right away.
+					if (found != m_sessions.end()) {
+						m_sessions.erase(found);
+					}
+
+					std::vector<uint8_t> reply;
+					property_protocol::Writer out(reply);
+					property_protocol::WriteError(out, property_protocol::ecVersion, type, property_protocol::Version);
+
+					if (m_send) {
+						m_send(session_id, std::move(reply));
+					}
+
+					return;
+				}
+
+				// A second HELLO starts the session over.
+				session& s = m_sessions[session_id];
+				s = session();
+				property_protocol::Writer out(s.outbound);
+
+				out.Begin(property_protocol::mtHelloReply);
+				out.U32(property_protocol::Magic);
+				out.U8(property_protocol::Version);
+				out.End();
+
+				SIM_INFO(sim::telemetry::event::EV_SESSION_OPENED, session_id);
+				return;
+			}
+
+			if (found == m_sessions.end()) {
+				// Nowhere to send an error: the session was never opened, or is closed already.
+				return;
+			}
+
+			session& s = found->second;
+			property_protocol::Writer out(s.outbound);
+
+			auto valid = [&s, this](uint16_t id) {
+				return id < s.registrations.size() && m_store.valid(s.registrations[id].ref);
+			};
+
+			switch (type) {
+				case property_protocol::mtRegister:
+					register_paths(s, in);
+					break;
+
+				case property_protocol::mtSet: {
+					uint16_t count = in.U16();
+
+					for (uint16_t i = 0; i < count; ++i) {
+						uint16_t id = in.U16();
+						double value = in.F64();
+
+						if (!in.Good()) {
+							break;
+						}
+
+						if (!valid(id)) {
+							property_protocol::WriteError(out, property_protocol::ecUnknownID, type, id);
+						} else if (!m_store.set(s.registrations[id].ref, value)) {
+							property_protocol::WriteError(out, property_protocol::ecNotLeaf, type, id);
+						}
+					}
+					break;
+				}
+
+				case property_protocol::mtSubscribe:
+				case property_protocol::mtUnsubscribe: {
+					double period = 0.0;
+					double deadband = 0.0;
+
+					if (type == property_protocol::mtSubscribe) {
+						period = in.F64();
+						deadband = in.F64();
+					}
+
+					uint16_t count = in.U16();
+
+					for (uint16_t i = 0; i < count; ++i) {
+						uint16_t id = in.U16();
+
+						if (!in.Good()) {
+							break;
+						}
+
+						if (!valid(id)) {
+							property_protocol::WriteError(out, property_protocol::ecUnknownID, type, id);
+							continue;
+						}
+
+						registration& reg = s.registrations[id];
+						reg.subscribed = type == property_protocol::mtSubscribe;
+						reg.fresh = reg.subscribed;
+						reg.period = period;
+						reg.deadband = std::fabs(deadband);
+					}
+					break;
+				}
+
+				case property_protocol::mtGet: {
+					uint16_t count = in.U16();
+
+					for (uint16_t i = 0; i < count; ++i) {
+						uint16_t id = in.U16();
+						double value;
+
+						if (!in.Good()) {
+							break;
+						}
+
+						if (valid(id) && read(s.registrations[id], value)) {
+							add_update(s, id, value);
+						} else {
+							end_update(s);
+							property_protocol::WriteError(out, property_protocol::ecUnknownID, type, id);
+						}
+					}
+
+					end_update(s);
+					break;
+				}
+
+				case property_protocol::mtBye:
+					SIM_INFO(sim::telemetry::event::EV_SESSION_CLOSED, session_id);
+					m_sessions.erase(found);
+					return;
+
+				default:
+					// CONTROL included: the server has no hold or iterate of its own.
+					property_protocol::WriteError(out, property_protocol::ecBadMessage, type, 0);
+					return;
+			}
+
+			if (!in.Good()) {
+				property_protocol::WriteError(out, property_protocol::ecBadMessage, type, 0);
+			}
+		}
+
+		void property_sessions::register_paths(session& s, property_protocol::Reader& in) {
+			property_protocol::Writer out(s.outbound);
+			uint16_t count = in.U16();
+			uint16_t registered = 0;
+
+			out.Begin(property_protocol::mtRegistered);
+			std::size_t mark = out.Mark();
+
+			for (uint16_t i = 0; i < count; ++i) {
+				in.String(m_path);
+
+				if (!in.Good()) {
+					break;
+				}
+
+				out.U16(find_or_register(s, m_path));
+				++registered;
+			}
+
+			out.Patch(mark, registered);
+			out.End();
+		}
+
+		uint16_t property_sessions::find_or_register(session& s, const std::string& path) {
+			for (std::size_t i = 0; i < s.registrations.size(); ++i) {
+				if (s.registrations[i].path == path) {
+					return static_cast<uint16_t>(i);
+				}
+			}
+
+			std::string::size_type slash = path.find('/');
+
+			if (slash == std::string::npos || s.registrations.size() >= property_protocol::InvalidID) {
+				return property_protocol::InvalidID;
+			}
+
+			registration reg = { property_ref(), path, false, false, 0.0, 0.0, 0.0, 0.0 };
+
+			if (!m_store.resolve(path.substr(0, slash), path.substr(slash + 1), reg.ref)) {
+				return property_protocol::InvalidID;
+			}
+
+			s.registrations.push_back(reg);
+			return static_cast<uint16_t>(s.registrations.size() - 1);
+		}
+
+		void property_sessions::save(std::vector<uint8_t>& buffer) const {
+			property_protocol::Writer out(buffer);
+
+			out.U32(static_cast<uint32_t>(m_sessions.size()));
+
+			for (const auto& entry : m_sessions) {
+				const session& s = entry.second;
+
+				out.U32(entry.first);
+				out.U16(static_cast<uint16_t>(s.registrations.size()));
+
+				for (const registration& reg : s.registrations) {
+					out.String(reg.path);
+					out.U8(uint8_t(m_store.valid(reg.ref)) | uint8_t(reg.subscribed) << 1 | uint8_t(reg.fresh) << 2);
+					out.F64(reg.period);
+					out.F64(reg.deadband);
+					out.F64(reg.published);
+					out.F64(reg.publishedAt);
+				}
+			}
+		}
+
+		bool property_sessions::restore(const uint8_t* data, std::size_t size) {
+			property_protocol::Reader in(data, size);
+			bool good = true;
+
+			m_sessions.clear();
+
+			uint32_t count = in.U32();
+
+			for (uint32_t i = 0; i < count && good; ++i) {
+				session& s = m_sessions[in.U32()];
+				uint16_t registrations = in.U16();
+
+				for (uint16_t id = 0; id < registrations && good; ++id) {
+					in.String(m_path);
+					uint8_t flags = in.U8();
+					double period = in.F64();
+					double deadband = in.F64();
+					double published = in.F64();
+					double publishedAt = in.F64();
+
+					// Only "<entity>/<property>" paths are ever registered.
+					std::string::size_type slash = m_path.find('/');
+					good = in.Good() && slash != std::string::npos;
+
+					if (!good) {
+						break;
+					}
+
+					registration reg = { property_ref(), m_path, (flags & 2) != 0, (flags & 4) != 0, period, deadband, published, publishedAt };
+
+					if (flags & 1) {
+						m_store.resolve(m_path.substr(0, slash), m_path.substr(slash + 1), reg.ref);
+					}
+
+					s.registrations.push_back(reg);
+				}
+
+				good = good && in.Good();
+			}
+
+			if (!good) {
+				m_sessions.clear();
+			}
+
+			return good;
+		}
+
+		bool property_sessions::read(const registration& reg, double& value) {
+			return m_store.get(reg.ref, value);
+		}
+
+		void property_sessions::publish(double now) {
+			m_now = now;
+
+			for (auto& entry : m_sessions) {
+				session& s = entry.second;
+
+				for (std::size_t id = 0; id < s.registrations.size(); ++id) {
+					registration& reg = s.registrations[id];
+					double value;
+
+					if (!reg.subscribed || !read(reg, value)) {
+						continue;
+					}
+
+					if (!reg.fresh) {
+						bool moved = std::isnan(value) != std::isnan(reg.published) || std::fabs(value - reg.published) > reg.deadband;
+
+						// Changes that are not due yet stay pending until they are.
+						if (!moved || (now >= reg.publishedAt && now - reg.publishedAt < reg.period)) {
+							continue;
+						}
+					}
+
+					add_update(s, static_cast<uint16_t>(id), value);
+					reg.fresh = false;
+					reg.published = value;
+					reg.publishedAt = now;
+				}
+
+				end_update(s);
+
+				if (!s.outbound.empty()) {
+					if (m_send) {
+						m_send(entry.first, std::move(s.outbound));
+					}
+
+					s.outbound.clear();
+				}
+			}
+		}
+
+		void property_sessions::add_update(session& s, uint16_t id, double value) {
+			property_protocol::Writer out(s.outbound);
+
+			if (s.updateCount == 0) {
+				s.updateStart = out.Begin(property_protocol::mtUpdate);
+				out.F64(m_now);
+				s.updateMark = out.Mark();
+			}
+
+			out.U16(id);
+			out.F64(value);
+
+			if (++s.updateCount == max_update_entries) {
+				end_update(s);
+			}
+		}
+
+		void property_sessions::end_update(session& s) {
+			if (s.updateCount == 0) {
+				return;
+			}
+
+			property_protocol::Writer out(s.outbound);
+			out.Patch(s.updateMark, static_cast<uint16_t>(s.updateCount));
+			out.End(s.updateStart);
+			s.updateCount = 0;
+		}
+	}
+}
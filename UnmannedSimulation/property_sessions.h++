@@ -0,0 +1,157 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <jsbsim/input_output/FGPropertyProtocol.h>
+
+#include "entity_registry.h++"
+
+namespace sim {
+	namespace networking {
+
+		typedef JSBSim::FGPropertyProtocol property_protocol;
+
+		///
+		/// A property of an entity, as resolved by a property_store. What the fields hold is up to the
+		/// store; a default constructed reference is never valid.
+		///
+
+		struct property_ref {
+			uint64_t              entity = 0;
+			uint32_t              index  = 0;
+			boost::python::object key;
+		};
+
+		///
+		/// Where property sessions read and write the properties of entities.
+		///
+
+		class property_store {
+			public:
+				virtual ~property_store() { }
+
+				// Resolves `property` of the entity named `entity` into `ref`. Returns false if there is
+				// no such entity, or if the store can tell already that it has no such property.
+				virtual bool resolve(const std::string& entity, const std::string& property, property_ref& ref) = 0;
+
+				// Returns false once the entity of `ref` is gone.
+				virtual bool valid(const property_ref& ref) const = 0;
+
+				// Both return false if the entity does not answer for the property.
+				virtual bool get(const property_ref& ref, double& value) = 0;
+				virtual bool set(const property_ref& ref, double value) = 0;
+		};
+
+		///
+		/// The properties of the entities of a registry: whatever an entity's script answers to
+		/// `getProperty(name)` and `setProperty(name, value)`. Only properties the script answers for
+		/// when they are resolved are resolved.
+		///
+
+		class entity_properties : public property_store {
+			public:
+				explicit entity_properties(sim::entities::registry& entities) : m_entities(entities) { }
+
+				bool resolve(const std::string& entity, const std::string& property, property_ref& ref) override;
+				bool valid(const property_ref& ref) const override;
+				bool get(const property_ref& ref, double& value) override;
+				bool set(const property_ref& ref, double value) override;
+
+			private:
+				sim::entities::registry& m_entities;
+		};
+
+		///
+		/// The binary property sessions of the simulation server.
+		///
+		/// This is the server end of the protocol JSBSim serves with FGBinarySocket (see
+		/// FGPropertyProtocol.h for the messages). A client registers "<entity>/<property>" paths once,
+		/// then sets them and subscribes to them by the IDs it got back. What a property is depends on
+		/// the property_store the sessions are given; a path that does not resolve is registered as
+		/// InvalidID. The entity is resolved once, at registration; an ID whose entity is destroyed
+		/// later is reported as unknown.
+		///
+		/// Messages are applied on the simulation thread as the frame's commands, so they are journaled
+		/// and replayed like any other. Keyframes hold the open sessions and their registrations (see
+		/// save()), so that a replay seeking past a HELLO or a REGISTER still applies the SETs that
+		/// follow it. Subscriptions are published once per frame, after physics, with the simulation
+		/// time of the end of the frame; a GET is answered with the values as of the last publish.
+		///
+		/// A sharded coordinator serves its sessions from the shared segment of the shards (see
+		/// sim::sharding::shard_properties); it is not journaled.
+		///
+
+		class property_sessions {
+			public:
+				// Delivers what a session is sent. Without one, as in a replay, replies and updates are
+				// dropped.
+				typedef std::function<void(uint32_t session, std::vector<uint8_t>&& bytes)> sender;
+
+				explicit property_sessions(property_store& store);
+				virtual ~property_sessions();
+
+				void set_sender(sender send) { m_send = send; }
+
+				// Applies one framed message of `session`. A HELLO opens the session and a BYE closes it;
+				// anything else is only accepted in between. A HELLO of the wrong magic or version is
+				// answered with an error and leaves the session closed.
+				void process(uint32_t session, const uint8_t* message, std::size_t size);
+
+				// Queues the changes of every subscription as of simulation time `now`, then hands each
+				// session whatever it has been queued this frame.
+				void publish(double now);
+
+				std::size_t size() const { return m_sessions.size(); }
+
+				// Appends the open sessions, with their registrations and subscriptions, to `buffer`.
+				// Nothing queued for sending is saved: it is sent by the end of the frame it was queued in.
+				void save(std::vector<uint8_t>& buffer) const;
+
+				// Replaces the sessions with those written by save(). Registrations are resolved again
+				// through the store; one whose entity was gone when it was saved stays unknown. Returns
+				// false, leaving no session open, if `data` is truncated.
+				bool restore(const uint8_t* data, std::size_t size);
+
+			private:
+				struct registration {
+					property_ref                 ref;
+					std::string                  path;
+					bool                         subscribed;
+					bool                         fresh;       // subscribed and not published yet
+					double                       period;
+					double                       deadband;
+					double                       published;   // last value sent
+					double                       publishedAt;
+				};
+
+				struct session {
+					std::vector<registration> registrations;
+					std::vector<uint8_t>      outbound;
+					std::size_t               updateCount = 0;   // entries of the UPDATE being written
+					std::size_t               updateStart = 0;
+					std::size_t               updateMark  = 0;
+				};
+
+				void register_paths(session& s, property_protocol::Reader& in);
+				uint16_t find_or_register(session& s, const std::string& path);
+
+				// Returns the value of a registration, or false if its entity is gone or did not answer.
+				bool read(const registration& reg, double& value);
+
+				void add_update(session& s, uint16_t id, double value);
+				void end_update(session& s);
+
+				property_store&              m_store;
+				std::map<uint32_t, session>  m_sessions;
+				sender                       m_send;
+				double                       m_now;
+				std::string                  m_path;
+		};
+	}
+}
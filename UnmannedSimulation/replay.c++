@@ -0,0 +1,221 @@
+#include "stdafx.h"
+
+#include "replay.h++"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace sim {
+	namespace replay {
+
+		namespace {
+			void put_u32(std::vector<uint8_t>& buffer, uint32_t value) {
+				const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+				buffer.insert(buffer.end(), bytes, bytes + sizeof(value));
+			}
+
+			void put_bytes(std::vector<uint8_t>& buffer, const void* data, std::size_t size) {
+				put_u32(buffer, static_cast<uint32_t>(size));
+				const uint8_t* bytes = static_cast<const uint8_t*>(data);
+				buffer.insert(buffer.end(), bytes, bytes + size);
+			}
+
+			// Cursor over a record payload; reading past its end yields zeros and marks it bad.
+			struct payload_reader {
+				const uint8_t* data;
+				std::size_t    size;
+				std::size_t    offset;
+				bool           good;
+
+				payload_reader(const record& rec) : data(rec.data), size(rec.size), offset(0), good(true) { }
+
+				uint32_t u32() {
+					uint32_t value = 0;
+					if (offset + sizeof(value) > size) {
+						good = false;
+						return 0;
+					}
+					std::memcpy(&value, data + offset, sizeof(value));
+					offset += sizeof(value);
+					return value;
+				}
+
+				const uint8_t* bytes(uint32_t& length) {
+					length = u32();
+					if (offset + length > size) {
+						good = false;
+						length = 0;
+						return data;
+					}
+					const uint8_t* start = data + offset;
+					offset += length;
+					return start;
+				}
+			};
+		}
+
+		void reseed(uint32_t seed) {
+			std::srand(seed);
+
+			try {
+				boost::python::import("random").attr("seed")(seed);
+			} catch (const boost::python::error_already_set&) {
+				std::cerr << ">>> Error! Uncaught exception:\n";
+				PyErr_Print();
+			}
+		}
+
+		// recorder
+		recorder::recorder(const std::string& path, uint32_t seed, uint64_t keyframe_interval) :
+			m_journal(path),
+			m_seeds(seed),
+			m_keyframeInterval(keyframe_interval > 0 ? keyframe_interval : 1) { }
+
+		recorder::~recorder() { }
+
+		void recorder::begin_frame(uint64_t frame, sim::entities::registry& entities, const sim::networking::property_sessions& sessions) {
+			if (frame % m_keyframeInterval != 0) {
+				return;
+			}
+
+			uint32_t seed = static_cast<uint32_t>(m_seeds());
+
+			reseed(seed);
+			write_keyframe(frame, seed, entities, sessions);
+		}
+
+		void recorder::write_keyframe(uint64_t frame, uint32_t seed, sim::entities::registry& entities, const sim::networking::property_sessions& sessions) {
+			m_buffer.clear();
+
+			put_u32(m_buffer, seed);
+			put_u32(m_buffer, static_cast<uint32_t>(entities.size()));
+
+			// Entities are keyed by name: handles do not survive a restart of the server.
+			for (std::size_t i = 0; i < entities.size(); ++i) {
+				entities.script_at(i).saveState(m_state);
+
+				const std::string& name = entities.names()[i];
+				put_bytes(m_buffer, name.data(), name.size());
+				put_bytes(m_buffer, m_state.data(), m_state.size());
+			}
+
+			// The sessions go last, so that journals written before they were kept still read back.
+			m_sessions.clear();
+			sessions.save(m_sessions);
+			put_bytes(m_buffer, m_sessions.data(), m_sessions.size());
+
+			m_journal.append(record_kind::RK_KEYFRAME, frame, m_buffer.data(), static_cast<uint32_t>(m_buffer.size()));
+		}
+
+		void recorder::record_command(uint64_t frame, const sim::networking::command& cmd) {
+			m_buffer.clear();
+
+			put_u32(m_buffer, static_cast<uint32_t>(cmd.type));
+			m_buffer.insert(m_buffer.end(), cmd.data.begin(), cmd.data.end());
+
+			m_journal.append(record_kind::RK_COMMAND, frame, m_buffer.data(), static_cast<uint32_t>(m_buffer.size()));
+		}
+
+		// player
+		player::player(const std::string& path) : m_journal(path) { }
+
+		player::~player() { }
+
+		uint64_t player::seek(uint64_t frame, sim::entities::registry& entities, sim::networking::property_sessions& sessions) {
+			record rec;
+
+			if (!m_journal.seek(frame) || !m_journal.next(rec)) {
+				std::cerr << "No keyframe at or before frame " << frame << ", replaying from the start." << std::endl;
+				m_journal.rewind();
+				return 0;
+			}
+
+			restore_keyframe(rec, &entities, &sessions);
+			return rec.frame;
+		}
+
+		bool player::play_frame(uint64_t frame, sim::networking::message_handler& handler) {
+			record rec;
+
+			while (m_journal.peek(rec) && rec.frame <= frame) {
+				m_journal.next(rec);
+
+				if (rec.frame < frame) {
+					continue;
+				}
+
+				switch (rec.kind) {
+					case record_kind::RK_KEYFRAME:
+						restore_keyframe(rec, nullptr, nullptr);
+						break;
+
+					case record_kind::RK_COMMAND: {
+						payload_reader payload(rec);
+						sim::message::message_type type = static_cast<sim::message::message_type>(payload.u32());
+
+						if (payload.good) {
+							handler.process_message(type, std::vector<uint8_t>(rec.data + payload.offset, rec.data + rec.size));
+						}
+						break;
+					}
+
+					default:
+						std::cerr << "Skipping journal record of unknown kind " << static_cast<uint32_t>(rec.kind) << " at frame " << rec.frame << std::endl;
+						break;
+				}
+			}
+
+			return frame <= m_journal.last_frame();
+		}
+
+		// Reseeds from a keyframe and, when `entities` and `sessions` are given, restores their state too.
+		// Keyframes met while playing forward only reseed: the entities and the sessions already are in
+		// the recorded state.
+		void player::restore_keyframe(const record& rec, sim::entities::registry* entities, sim::networking::property_sessions* sessions) {
+			payload_reader payload(rec);
+
+			uint32_t seed = payload.u32();
+			uint32_t count = payload.u32();
+
+			reseed(seed);
+
+			if (!entities) {
+				return;
+			}
+
+			for (uint32_t i = 0; i < count && payload.good; ++i) {
+				uint32_t nameLength, stateLength;
+				const uint8_t* name = payload.bytes(nameLength);
+				const uint8_t* state = payload.bytes(stateLength);
+
+				if (!payload.good) {
+					break;
+				}
+
+				sim::entities::entity_handle entity = entities->find(std::string(reinterpret_cast<const char*>(name), nameLength));
+
+				if (!entities->valid(entity)) {
+					std::cerr << "Keyframe at frame " << rec.frame << " names an unknown entity." << std::endl;
+					continue;
+				}
+
+				m_state.assign(reinterpret_cast<const char*>(state), stateLength);
+				entities->script(entity).restoreState(m_state);
+			}
+
+			// A journal written before keyframes held the sessions ends here; its replay starts with none.
+			if (payload.good && payload.offset < payload.size) {
+				uint32_t sessionsLength;
+				const uint8_t* sessionState = payload.bytes(sessionsLength);
+
+				if (payload.good && !sessions->restore(sessionState, sessionsLength)) {
+					payload.good = false;
+				}
+			}
+
+			if (!payload.good) {
+				std::cerr << "Keyframe at frame " << rec.frame << " is truncated." << std::endl;
+			}
+		}
+	}
+}
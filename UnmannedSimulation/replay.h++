@@ -0,0 +1,87 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "command_queue.h++"
+#include "journal.h++"
+#include "message_handler.h++"
+#include "entity_registry.h++"
+
+namespace sim {
+	namespace replay {
+
+		///
+		/// Reseeds every random number source the simulation draws from: the C library's `rand()`,
+		/// which JSBSim uses, and Python's `random` module, used by the entity scripts.
+		///
+
+		void reseed(uint32_t seed);
+
+		///
+		/// Journals a live run so that it can be replayed.
+		///
+		/// Every inbound command is recorded against the frame it is applied on. Every
+		/// `keyframe_interval` frames (and on frame 0) the recorder reseeds the random number
+		/// generators with a fresh seed and writes a keyframe holding that seed, a snapshot of every
+		/// entity and the open property sessions, which is where a replay can start from.
+		///
+		/// Within a frame the order is: keyframe, commands, physics update. The player follows the same
+		/// order.
+		///
+
+		class recorder {
+			public:
+				recorder(const std::string& path, uint32_t seed, uint64_t keyframe_interval);
+				virtual ~recorder();
+
+				// Called at the start of every frame, before its commands are applied.
+				void begin_frame(uint64_t frame, sim::entities::registry& entities, const sim::networking::property_sessions& sessions);
+
+				void record_command(uint64_t frame, const sim::networking::command& cmd);
+
+				// Called once `frame` has been simulated, so that a replay runs up to it.
+				void end_frame(uint64_t frame) { m_journal.end_frame(frame); }
+
+			private:
+				void write_keyframe(uint64_t frame, uint32_t seed, sim::entities::registry& entities, const sim::networking::property_sessions& sessions);
+
+				journal_writer       m_journal;
+				std::mt19937         m_seeds;
+				uint64_t             m_keyframeInterval;
+				std::vector<uint8_t> m_buffer;
+				std::vector<uint8_t> m_sessions;
+				std::string          m_state;
+		};
+
+		///
+		/// Re-drives a simulation from a journal, without network and without pacing.
+		///
+
+		class player {
+			public:
+				explicit player(const std::string& path);
+				virtual ~player();
+
+				// Restores the entities, the property sessions and the random seed from the last keyframe
+				// at or before `frame` and returns the frame replay resumes from.
+				uint64_t seek(uint64_t frame, sim::entities::registry& entities, sim::networking::property_sessions& sessions);
+
+				// Applies the records of `frame`: reseeds on a keyframe and hands commands to `handler`.
+				// Returns false once `frame` is past the last frame the run completed.
+				bool play_frame(uint64_t frame, sim::networking::message_handler& handler);
+
+				const journal_reader& journal() const { return m_journal; }
+
+			private:
+				void restore_keyframe(const record& rec, sim::entities::registry* entities, sim::networking::property_sessions* sessions);
+
+				journal_reader m_journal;
+				std::string    m_state;
+		};
+	}
+}
@@ -4,9 +4,11 @@
 
 namespace sim {
 	namespace networking {
-		server::server(boost::asio::io_service& io_service) :
+		server::server(boost::asio::io_service& io_service, command_queue& commands) :
 			m_tcpSocket(io_service),
-			m_acceptor(io_service, boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), 2014)) {
+			m_acceptor(io_service, boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), 2014)),
+			m_commands(commands),
+			m_nextSession(1) {
 
 			m_acceptor.listen();
 			accept();
@@ -16,7 +18,7 @@ namespace sim {
 
 		void server::accept() {
 			tcp_connection::pointer new_connection =
-				tcp_connection::create(m_acceptor.get_io_service());
+				tcp_connection::create(m_acceptor.get_io_service(), m_commands, m_nextSession++);
 
 			m_acceptor.async_accept(new_connection->socket(),
 				boost::bind(&server::accept_handler, this, new_connection, boost::asio::placeholders::error));
@@ -25,11 +27,41 @@ namespace sim {
 		void server::accept_handler(boost::shared_ptr<tcp_connection> new_connection, const boost::system::error_code& err) {
 			if (!err)
 			{
-				std::cout << "A new client has joined the fray." << std::endl;
+				SIM_INFO(sim::telemetry::event::EV_CLIENT_JOINED, new_connection->session());
+
+				{
+					std::lock_guard<std::mutex> lock(m_connectionsMutex);
+
+					// Forget the connections that have gone since the last one came.
+					for (auto it = m_connections.begin(); it != m_connections.end(); ) {
+						it = it->second.expired() ? m_connections.erase(it) : std::next(it);
+					}
+
+					m_connections[new_connection->session()] = new_connection;
+				}
+
 				new_connection->start();
 			}
 
 			accept();
 		}
+
+		void server::send(uint32_t session, std::vector<uint8_t>&& bytes) {
+			tcp_connection::pointer connection;
+
+			{
+				std::lock_guard<std::mutex> lock(m_connectionsMutex);
+
+				auto found = m_connections.find(session);
+
+				if (found != m_connections.end()) {
+					connection = found->second.lock();
+				}
+			}
+
+			if (connection) {
+				connection->send(std::move(bytes));
+			}
+		}
 	}
 }
\ No newline at end of file
@@ -2,17 +2,28 @@
 
 #include "stdafx.h"
 
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 #include <boost/asio.hpp>
+#include <boost/weak_ptr.hpp>
 
+#include "command_queue.h++"
 #include "connection.h++"
 
 namespace sim {
 	namespace networking {
 		class server {
 			public:
-				server(boost::asio::io_service& io_service);
+				server(boost::asio::io_service& io_service, command_queue& commands);
 				virtual ~server();
 
+				// Sends bytes to the connection of a session, if it is still there. Safe to call from the
+				// simulation thread.
+				void send(uint32_t session, std::vector<uint8_t>&& bytes);
+
 			protected:
 				void accept();
 				void accept_handler(boost::shared_ptr<tcp_connection> newConnection, const boost::system::error_code& err);
@@ -20,6 +31,12 @@ namespace sim {
 			private:
 				boost::asio::ip::tcp::acceptor m_acceptor;
 				boost::asio::ip::tcp::socket   m_tcpSocket;
+				command_queue&                 m_commands;
+
+				// Every connection is given a session id, counting from 1, on the IO thread.
+				uint32_t                                                         m_nextSession;
+				std::mutex                                                       m_connectionsMutex;
+				std::unordered_map<uint32_t, boost::weak_ptr<tcp_connection>>   m_connections;
 		};
 	}
 }
\ No newline at end of file
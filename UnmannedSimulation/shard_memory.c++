@@ -0,0 +1,314 @@
+#include "stdafx.h"
+
+#include "shard_memory.h++"
+
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+namespace sim {
+	namespace sharding {
+
+		namespace {
+			const uint32_t segment_magic = 0x44524853; // "SHRD"
+
+			std::size_t segment_size(uint32_t shard_count) {
+				return sizeof(segment_header) + shard_count * sizeof(shard_block);
+			}
+		}
+
+		uint32_t shard_of(const std::string& name, uint32_t shard_count) {
+			// FNV-1a, which unlike std::hash is the same in every build.
+			uint32_t hash = 2166136261u;
+
+			for (unsigned char c : name) {
+				hash = (hash ^ c) * 16777619u;
+			}
+
+			return shard_count > 0 ? hash % shard_count : 0;
+		}
+
+		segment::segment(const std::string& name, uint32_t shard_count) :
+			m_name(name),
+			m_header(nullptr),
+			m_shards(nullptr) {
+
+			if (shard_count == 0) {
+				throw std::invalid_argument("a sharded run needs at least one shard");
+			}
+
+			boost::interprocess::shared_memory_object::remove(name.c_str());
+
+			boost::interprocess::shared_memory_object(boost::interprocess::create_only, name.c_str(), boost::interprocess::read_write).swap(m_memory);
+			m_memory.truncate(segment_size(shard_count));
+
+			map();
+
+			// The mapping comes back zeroed; constructing the atomics in place is all that is left.
+			new (m_header) segment_header();
+			m_header->magic = segment_magic;
+			m_header->shardCount = shard_count;
+			m_header->released.store(0);
+			m_header->stopping.store(0);
+
+			for (uint32_t i = 0; i < shard_count; ++i) {
+				shard_block* block = new (&m_shards[i]) shard_block();
+				block->status.store(static_cast<uint32_t>(shard_status::SS_STOPPED));
+				block->completed.store(0);
+				block->watchCount.store(0);
+				block->setHead.store(0);
+				block->setTail.store(0);
+
+				for (uint32_t j = 0; j < ring_depth; ++j) {
+					block->ring[j].sequence.store(0);
+				}
+			}
+		}
+
+		segment::segment(const std::string& name) :
+			m_name(name),
+			m_header(nullptr),
+			m_shards(nullptr) {
+
+			boost::interprocess::shared_memory_object(boost::interprocess::open_only, name.c_str(), boost::interprocess::read_write).swap(m_memory);
+
+			map();
+
+			if (m_header->magic != segment_magic || m_region.get_size() < segment_size(m_header->shardCount)) {
+				throw std::runtime_error("shared memory segment " + name + " is not a shard segment");
+			}
+		}
+
+		segment::~segment() { }
+
+		void segment::map() {
+			boost::interprocess::mapped_region(m_memory, boost::interprocess::read_write).swap(m_region);
+
+			m_header = static_cast<segment_header*>(m_region.get_address());
+			m_shards = reinterpret_cast<shard_block*>(m_header + 1);
+		}
+
+		void segment::publish(uint32_t index, uint64_t frame, sim::entities::registry& entities,
+			const std::vector<double>& values, const std::vector<uint8_t>& answered) {
+			shard_block& block = m_shards[index];
+			frame_slot& slot = block.ring[frame % ring_depth];
+
+			// A writer that crashed mid-frame leaves the sequence odd; step over it to the next odd value.
+			uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+			uint32_t writing = (sequence & 1) ? sequence + 2 : sequence + 1;
+
+			slot.sequence.store(writing, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+
+			uint32_t count = entities.size() < max_shard_entities ? static_cast<uint32_t>(entities.size()) : max_shard_entities;
+
+			for (uint32_t i = 0; i < count; ++i) {
+				entity_record& rec = slot.entities[i];
+				const std::string& name = entities.names()[i];
+				SimEntity& script = entities.script_at(i);
+
+				rec.handle = entities.handles()[i].value();
+				rec.flags = script.position(rec.position) ? EF_HAS_POSITION : 0;
+
+				rec.nameLength = static_cast<uint32_t>(name.size() < max_entity_name ? name.size() : max_entity_name);
+				std::memcpy(rec.name, name.data(), rec.nameLength);
+
+				script.saveState(m_state);
+
+				if (m_state.size() <= max_entity_state) {
+					rec.stateSize = static_cast<uint32_t>(m_state.size());
+					std::memcpy(rec.state, m_state.data(), m_state.size());
+				} else {
+					rec.stateSize = 0;
+					rec.flags |= EF_STATE_DROPPED;
+				}
+			}
+
+			uint32_t valueCount = values.size() < max_shard_watches ? static_cast<uint32_t>(values.size()) : max_shard_watches;
+
+			for (uint32_t i = 0; i < valueCount; ++i) {
+				slot.values[i] = values[i];
+				slot.answered[i] = answered[i];
+			}
+
+			slot.count = count;
+			slot.frame = frame;
+			slot.valueCount = valueCount;
+
+			slot.sequence.store(writing + 1, std::memory_order_release);
+			block.completed.store(frame, std::memory_order_release);
+		}
+
+		const frame_slot* segment::latest(uint32_t index) const {
+			uint64_t completed = m_shards[index].completed.load(std::memory_order_acquire);
+
+			if (completed == 0) {
+				return nullptr;
+			}
+
+			return &m_shards[index].ring[completed % ring_depth];
+		}
+
+		uint64_t segment::restore(uint32_t index, sim::entities::registry& entities) const {
+			const shard_block& block = m_shards[index];
+
+			// The worker that wrote this shard is gone, so nothing races us here; the newest slot whose
+			// sequence is even and non-zero holds the last frame it completed.
+			const frame_slot* newest = nullptr;
+
+			for (uint32_t i = 0; i < ring_depth; ++i) {
+				const frame_slot& slot = block.ring[i];
+				uint32_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+				if (sequence != 0 && !(sequence & 1) && (!newest || slot.frame > newest->frame)) {
+					newest = &slot;
+				}
+			}
+
+			if (!newest) {
+				return 0;
+			}
+
+			std::string state;
+
+			for (uint32_t i = 0; i < newest->count && i < max_shard_entities; ++i) {
+				const entity_record& rec = newest->entities[i];
+				std::string name(rec.name, rec.nameLength < max_entity_name ? rec.nameLength : max_entity_name);
+
+				sim::entities::entity_handle entity = entities.find(name);
+
+				if (!entities.valid(entity)) {
+					std::cerr << "Shard " << index << " published an entity it no longer has: " << name << std::endl;
+					continue;
+				}
+
+				if (rec.flags & EF_STATE_DROPPED) {
+					std::cerr << "No state was kept for " << name << ", its snapshot is larger than " << max_entity_state << " bytes." << std::endl;
+					continue;
+				}
+
+				state.assign(reinterpret_cast<const char*>(rec.state), rec.stateSize < max_entity_state ? rec.stateSize : max_entity_state);
+				entities.script(entity).restoreState(state);
+			}
+
+			return newest->frame;
+		}
+
+		void segment::query_radius(const double (&center)[3], double radius, std::vector<proximity_hit>& hits) const {
+			hits.clear();
+
+			for (uint32_t index = 0; index < m_header->shardCount; ++index) {
+				std::size_t first = hits.size();
+
+				auto gather = [&](const entity_record& rec) {
+					if (!(rec.flags & EF_HAS_POSITION)) {
+						return;
+					}
+
+					double dx = rec.position[0] - center[0];
+					double dy = rec.position[1] - center[1];
+					double dz = rec.position[2] - center[2];
+					double distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+					if (distance <= radius) {
+						uint32_t length = rec.nameLength < max_entity_name ? rec.nameLength : max_entity_name;
+						hits.push_back(proximity_hit{ index, rec.handle, std::string(rec.name, length), distance });
+					}
+				};
+
+				// A torn read means the shard moved on to a newer frame meanwhile; read that one instead.
+				while (!visit_latest(index, gather)) {
+					hits.resize(first);
+				}
+			}
+		}
+
+		uint32_t segment::watch(uint32_t index, const std::string& entity, const std::string& property) {
+			shard_block& block = m_shards[index];
+			uint32_t count = block.watchCount.load(std::memory_order_relaxed);
+
+			if (entity.size() > max_entity_name || property.size() > max_property_name) {
+				return max_shard_watches;
+			}
+
+			for (uint32_t i = 0; i < count; ++i) {
+				const watch_entry& entry = block.watches[i];
+
+				if (entity.compare(0, std::string::npos, entry.entity, entry.entityLength) == 0
+					&& property.compare(0, std::string::npos, entry.property, entry.propertyLength) == 0) {
+					return i;
+				}
+			}
+
+			if (count == max_shard_watches) {
+				return max_shard_watches;
+			}
+
+			watch_entry& entry = block.watches[count];
+			entry.entityLength = static_cast<uint32_t>(entity.size());
+			entry.propertyLength = static_cast<uint32_t>(property.size());
+			std::memcpy(entry.entity, entity.data(), entity.size());
+			std::memcpy(entry.property, property.data(), property.size());
+
+			block.watchCount.store(count + 1, std::memory_order_release);
+			return count;
+		}
+
+		bool segment::read_watch(uint32_t index, uint32_t watch, double& value) const {
+			// A torn read means the shard moved on to a newer frame meanwhile; read that one instead.
+			for (;;) {
+				const frame_slot* slot = latest(index);
+
+				if (!slot) {
+					return false;
+				}
+
+				uint32_t before = slot->sequence.load(std::memory_order_acquire);
+
+				if (before & 1) {
+					continue;
+				}
+
+				bool answered = watch < slot->valueCount && watch < max_shard_watches && slot->answered[watch];
+				double read = answered ? slot->values[watch] : 0.0;
+
+				std::atomic_thread_fence(std::memory_order_acquire);
+
+				if (slot->sequence.load(std::memory_order_relaxed) == before) {
+					value = read;
+					return answered;
+				}
+			}
+		}
+
+		bool segment::push_set(uint32_t index, uint32_t watch, double value) {
+			shard_block& block = m_shards[index];
+			uint64_t head = block.setHead.load(std::memory_order_relaxed);
+
+			if (head - block.setTail.load(std::memory_order_acquire) == set_ring_depth) {
+				return false;
+			}
+
+			set_entry& entry = block.sets[head % set_ring_depth];
+			entry.watch = watch;
+			entry.value = value;
+
+			block.setHead.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool segment::pop_set(uint32_t index, set_entry& entry) {
+			shard_block& block = m_shards[index];
+			uint64_t tail = block.setTail.load(std::memory_order_relaxed);
+
+			if (tail == block.setHead.load(std::memory_order_acquire)) {
+				return false;
+			}
+
+			entry = block.sets[tail % set_ring_depth];
+			block.setTail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+	}
+}
@@ -0,0 +1,262 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "entity_registry.h++"
+
+namespace sim {
+	namespace sharding {
+
+		const uint32_t max_shard_entities = 256;
+		const uint32_t max_entity_name    = 64;
+		const uint32_t max_entity_state   = 2048;
+		const uint32_t max_shard_watches  = 256;
+		const uint32_t max_property_name  = 64;
+
+		// SETs queued for a shard and not applied yet. The coordinator refuses more.
+		const uint32_t set_ring_depth = 1024;
+
+		// Frames each shard keeps in its ring. A reader holding on to the latest frame is only raced by
+		// the writer once the shard has run this many frames further.
+		const uint32_t ring_depth = 4;
+
+		// The atomics below live in memory shared between processes, which only works if they are
+		// implemented without a lock.
+		static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2, "shared memory atomics must be lock-free");
+
+		///
+		/// Life cycle of a shard, as seen by the coordinator
+		///
+
+		enum class shard_status : uint32_t
+		{
+			SS_STOPPED = 0,
+			SS_STARTING,     // process spawned, entities not loaded or restored yet
+			SS_READY,        // taking part in the frame barrier
+			SS_INVALID_OUT_OF_RANGE
+		};
+
+		enum entity_flags : uint32_t
+		{
+			EF_HAS_POSITION = 1,
+			EF_STATE_DROPPED = 2   // the snapshot did not fit in `state` and was not published
+		};
+
+		///
+		/// The state of one entity as published by its shard.
+		///
+		/// Entities are identified by name: the handle is the publishing worker's own and does not
+		/// survive a restart of that worker.
+		///
+
+		struct entity_record {
+			uint64_t handle;
+			double   position[3];
+			uint32_t flags;
+			uint32_t nameLength;
+			uint32_t stateSize;
+			char     name[max_entity_name];
+			uint8_t  state[max_entity_state];
+		};
+
+		///
+		/// One frame of a shard's entities, guarded by a sequence lock.
+		///
+		/// The writer makes `sequence` odd before it touches the slot and even again once it is done.
+		/// Readers look at the slot in place and afterwards check that `sequence` is the same even
+		/// value it was before; if not, what they read may be torn and has to be discarded. A sequence
+		/// of 0 means the slot has never been written.
+		///
+
+		struct frame_slot {
+			std::atomic<uint32_t> sequence;
+			uint32_t              count;
+			uint64_t              frame;
+			uint32_t              valueCount;
+			uint8_t               answered[max_shard_watches];   // whether the entity answered for values[i]
+			double                values[max_shard_watches];     // one per watch, in watch order
+			entity_record         entities[max_shard_entities];
+		};
+
+		///
+		/// A property the coordinator asked a shard to publish with every frame.
+		///
+
+		struct watch_entry {
+			uint32_t entityLength;
+			uint32_t propertyLength;
+			char     entity[max_entity_name];
+			char     property[max_property_name];
+		};
+
+		///
+		/// A SET of a watched property, queued by the coordinator for the shard to apply.
+		///
+
+		struct set_entry {
+			uint32_t watch;
+			uint32_t reserved;
+			double   value;
+		};
+
+		///
+		/// The watches of a shard only ever grow: the coordinator fills an entry, then publishes it
+		/// by bumping `watchCount`. SETs go through a single-producer, single-consumer ring, the
+		/// coordinator advancing `setHead` and the worker `setTail`; both outlive a restarted worker.
+		///
+
+		struct shard_block {
+			std::atomic<uint32_t> status;
+			std::atomic<uint64_t> completed;   // last frame published, 0 before the first
+			std::atomic<uint32_t> watchCount;
+			std::atomic<uint64_t> setHead;
+			std::atomic<uint64_t> setTail;
+			watch_entry           watches[max_shard_watches];
+			set_entry             sets[set_ring_depth];
+			frame_slot            ring[ring_depth];
+		};
+
+		struct segment_header {
+			uint32_t              magic;
+			uint32_t              shardCount;
+			std::atomic<uint64_t> released;    // last frame the shards may run
+			std::atomic<uint32_t> stopping;
+		};
+
+		///
+		/// A cross-shard proximity query result
+		///
+
+		struct proximity_hit {
+			uint32_t    shard;
+			uint64_t    handle;
+			std::string name;
+			double      distance;
+		};
+
+		// Assigns an entity to a shard. The assignment only depends on the name, so a restarted worker
+		// loads the same entities again.
+		uint32_t shard_of(const std::string& name, uint32_t shard_count);
+
+		///
+		/// The shared memory segment of a sharded run.
+		///
+		/// It holds a header, through which the coordinator releases frames, and one block per shard,
+		/// each with a ring of the shard's last `ring_depth` frames. The coordinator creates the segment
+		/// and the workers open it; mapping it is all it takes to read any shard's entities, without
+		/// copying them or asking the worker. Entity properties the coordinator's sessions use are
+		/// watched: the shard publishes their values with its frames, and applies the SETs the
+		/// coordinator queues for it before it runs its next frame.
+		///
+		/// Nothing in the segment is protected by an interprocess mutex: a worker that crashes while
+		/// holding one would leave it locked for everybody. Frame release and completion are single
+		/// atomics, and frame contents are guarded by per-slot sequence locks, so a crashed writer at
+		/// worst leaves behind a slot that readers skip.
+		///
+
+		class segment {
+			public:
+				// Creates the segment, replacing any left behind under the same name by an earlier run.
+				segment(const std::string& name, uint32_t shard_count);
+
+				// Opens the segment created by the coordinator.
+				explicit segment(const std::string& name);
+
+				virtual ~segment();
+
+				const std::string& name() const { return m_name; }
+
+				uint32_t shard_count() const { return m_header->shardCount; }
+
+				segment_header&    header()                    { return *m_header; }
+				shard_block&       shard(uint32_t index)       { return m_shards[index]; }
+				const shard_block& shard(uint32_t index) const { return m_shards[index]; }
+
+				// Publishes the entities of a worker, and the values of its watches, as `frame` of shard
+				// `index`. Entities beyond max_shard_entities are left out.
+				void publish(uint32_t index, uint64_t frame, sim::entities::registry& entities,
+					const std::vector<double>& values, const std::vector<uint8_t>& answered);
+
+				// Restores the entities of a restarted worker from the latest frame its shard published,
+				// matching them by name. Returns that frame, or 0 if the shard never published one.
+				uint64_t restore(uint32_t index, sim::entities::registry& entities) const;
+
+				// Calls `visit(const entity_record&)` on every entity of the latest frame of a shard,
+				// in place. Returns false if the frame was overwritten while it was being visited, in
+				// which case whatever `visit` gathered is to be thrown away; retry to read the new one.
+				template <typename Visitor>
+				bool visit_latest(uint32_t index, Visitor&& visit) const;
+
+				// Finds every entity, on any shard, within `radius` of `center`. Only entities that
+				// publish a position are considered. `hits` is cleared first.
+				void query_radius(const double (&center)[3], double radius, std::vector<proximity_hit>& hits) const;
+
+				// Asks shard `index` to publish `property` of `entity` with every frame from its next
+				// one on. Returns the watch the value is published under, the same for the same property,
+				// or max_shard_watches if the shard has no watch left. Coordinator only.
+				uint32_t watch(uint32_t index, const std::string& entity, const std::string& property);
+
+				// Reads watch `watch` from the latest frame of shard `index`. Returns false if no frame
+				// holds it yet or the entity did not answer for it.
+				bool read_watch(uint32_t index, uint32_t watch, double& value) const;
+
+				// Queues a SET of watch `watch` for shard `index`. Returns false if the ring is full.
+				// Coordinator only.
+				bool push_set(uint32_t index, uint32_t watch, double value);
+
+				// Takes the oldest SET queued for shard `index`. Returns false if there is none. Worker
+				// only.
+				bool pop_set(uint32_t index, set_entry& entry);
+
+			private:
+				segment(const segment&) = delete;
+				segment& operator=(const segment&) = delete;
+
+				void map();
+
+				// The slot holding the latest complete frame of a shard, or nullptr if there is none.
+				const frame_slot* latest(uint32_t index) const;
+
+				std::string                                m_name;
+				boost::interprocess::shared_memory_object  m_memory;
+				boost::interprocess::mapped_region         m_region;
+				segment_header*                            m_header;
+				shard_block*                               m_shards;
+				std::string                                m_state;
+		};
+
+		template <typename Visitor>
+		bool segment::visit_latest(uint32_t index, Visitor&& visit) const {
+			const frame_slot* slot = latest(index);
+
+			if (!slot) {
+				return true;
+			}
+
+			uint32_t before = slot->sequence.load(std::memory_order_acquire);
+
+			if (before & 1) {
+				return false;
+			}
+
+			uint32_t count = slot->count < max_shard_entities ? slot->count : max_shard_entities;
+
+			for (uint32_t i = 0; i < count; ++i) {
+				visit(slot->entities[i]);
+			}
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			return slot->sequence.load(std::memory_order_relaxed) == before;
+		}
+	}
+}
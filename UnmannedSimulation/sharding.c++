@@ -0,0 +1,362 @@
+#include "stdafx.h"
+
+#include "sharding.h++"
+
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+
+namespace sim {
+	namespace sharding {
+
+		namespace {
+			// Shard barriers spin for this many rounds before they start sleeping between checks.
+			const unsigned int spin_rounds = 1000;
+
+			const std::chrono::milliseconds poll_interval(1);
+
+			// A worker that sees no new frame for this long assumes the coordinator is gone and exits.
+			const std::chrono::seconds orphan_timeout(30);
+
+			std::string segment_name() {
+				return "UnmannedSimulation-shards-" + std::to_string(boost::this_process::get_id());
+			}
+
+			shard_status status_of(const shard_block& block) {
+				return static_cast<shard_status>(block.status.load(std::memory_order_acquire));
+			}
+
+			// Marks the property_ref indices of shard_properties that are contacts queries rather than
+			// watches.
+			const uint32_t contacts_property = 0x80000000u;
+
+			const std::string contacts_prefix = "contacts/";
+		}
+
+		// coordinator
+		coordinator::coordinator(const std::string& program, uint32_t shard_count, std::chrono::milliseconds frame_timeout) :
+			m_program(program),
+			m_frameTimeout(frame_timeout),
+			m_memory(segment_name(), shard_count),
+			m_workers(shard_count) { }
+
+		coordinator::~coordinator() {
+			m_memory.header().stopping.store(1, std::memory_order_release);
+
+			for (auto& child : m_workers) {
+				std::error_code ec;
+
+				if (child.valid() && !child.wait_for(std::chrono::seconds(2), ec)) {
+					child.terminate(ec);
+				}
+			}
+
+			boost::interprocess::shared_memory_object::remove(m_memory.name().c_str());
+		}
+
+		void coordinator::spawn(uint32_t index) {
+			m_memory.shard(index).status.store(static_cast<uint32_t>(shard_status::SS_STARTING), std::memory_order_release);
+
+			m_workers[index] = boost::process::child(m_program, "--shard=" + std::to_string(index), "--segment=" + m_memory.name());
+		}
+
+		void coordinator::restart(uint32_t index, const char* reason) {
+			std::cerr << "Shard " << index << " " << reason << ", restarting it from frame " << m_memory.shard(index).completed.load() << "." << std::endl;
+
+			std::error_code ec;
+			boost::process::child& child = m_workers[index];
+
+			if (child.running(ec)) {
+				child.terminate(ec);
+			}
+
+			child.wait(ec);
+
+			spawn(index);
+		}
+
+		void coordinator::start(std::chrono::milliseconds timeout) {
+			for (uint32_t i = 0; i < m_memory.shard_count(); ++i) {
+				spawn(i);
+			}
+
+			auto deadline = std::chrono::steady_clock::now() + timeout;
+
+			for (uint32_t i = 0; i < m_memory.shard_count(); ++i) {
+				std::error_code ec;
+
+				while (status_of(m_memory.shard(i)) != shard_status::SS_READY && std::chrono::steady_clock::now() < deadline) {
+					if (!m_workers[i].running(ec)) {
+						restart(i, "exited while starting");
+					}
+
+					std::this_thread::sleep_for(poll_interval);
+				}
+			}
+		}
+
+		void coordinator::run_frame(uint64_t frame) {
+			m_memory.header().released.store(frame, std::memory_order_release);
+
+			auto deadline = std::chrono::steady_clock::now() + m_frameTimeout;
+
+			for (uint32_t i = 0; i < m_memory.shard_count(); ++i) {
+				wait_for(i, frame, deadline);
+			}
+		}
+
+		bool coordinator::wait_for(uint32_t index, uint64_t frame, std::chrono::steady_clock::time_point deadline) {
+			const shard_block& block = m_memory.shard(index);
+			std::error_code ec;
+
+			for (unsigned int round = 0; ; ++round) {
+				if (status_of(block) == shard_status::SS_READY && block.completed.load(std::memory_order_acquire) >= frame) {
+					return true;
+				}
+
+				if (!m_workers[index].running(ec)) {
+					restart(index, "exited");
+					return false;
+				}
+
+				// A worker that is still loading or restoring is not part of the barrier yet.
+				if (status_of(block) != shard_status::SS_READY) {
+					return false;
+				}
+
+				if (std::chrono::steady_clock::now() >= deadline) {
+					restart(index, "missed the frame deadline");
+					return false;
+				}
+
+				if (round < spin_rounds) {
+					std::this_thread::yield();
+				} else {
+					std::this_thread::sleep_for(poll_interval);
+				}
+			}
+		}
+
+		// worker
+		worker::worker(segment& memory, uint32_t index) :
+			m_memory(memory),
+			m_index(index) { }
+
+		worker::~worker() { }
+
+		int worker::run(sim::entities::registry& entities) {
+			shard_block& block = m_memory.shard(m_index);
+
+			uint64_t last = m_memory.restore(m_index, entities);
+
+			if (last > 0) {
+				std::cout << "Shard " << m_index << " restored " << entities.size() << " entities from frame " << last << "." << std::endl;
+			}
+
+			// A restarted worker finds the coordinator some frames ahead of the state it restored. It
+			// runs each of them, in order, before it rejoins the barrier: skipping straight to the frame
+			// released last would leave its entities that many physics steps behind the others.
+			uint64_t restored = last;
+			uint64_t released = m_memory.header().released.load(std::memory_order_acquire);
+
+			while (last < released && !m_memory.header().stopping.load(std::memory_order_acquire)) {
+				step(++last, entities);
+			}
+
+			if (last > restored) {
+				std::cout << "Shard " << m_index << " ran frames " << restored + 1 << " to " << last << " to catch up." << std::endl;
+			}
+
+			block.status.store(static_cast<uint32_t>(shard_status::SS_READY), std::memory_order_release);
+
+			while (uint64_t frame = wait_release(last)) {
+				step(frame, entities);
+				last = frame;
+			}
+
+			block.status.store(static_cast<uint32_t>(shard_status::SS_STOPPED), std::memory_order_release);
+
+			return 0;
+		}
+
+		void worker::step(uint64_t frame, sim::entities::registry& entities) {
+			update_watches(entities);
+
+			set_entry set;
+
+			while (m_memory.pop_set(m_index, set)) {
+				if (set.watch < m_watches.size() && entities.valid(m_watches[set.watch].entity)) {
+					entities.script(m_watches[set.watch].entity).setProperty(m_watches[set.watch].key, set.value);
+				}
+			}
+
+			entities.update_physics();
+
+			for (std::size_t i = 0; i < m_watches.size(); ++i) {
+				const watched& w = m_watches[i];
+				m_answered[i] = entities.valid(w.entity) && entities.script(w.entity).getProperty(w.key, m_values[i]);
+			}
+
+			m_memory.publish(m_index, frame, entities, m_values, m_answered);
+		}
+
+		void worker::update_watches(sim::entities::registry& entities) {
+			const shard_block& block = m_memory.shard(m_index);
+			uint32_t count = block.watchCount.load(std::memory_order_acquire);
+
+			for (std::size_t i = m_watches.size(); i < count; ++i) {
+				const watch_entry& entry = block.watches[i];
+
+				watched w = {
+					entities.find(std::string(entry.entity, std::min(entry.entityLength, max_entity_name))),
+					boost::python::str(std::string(entry.property, std::min(entry.propertyLength, max_property_name)))
+				};
+
+				m_watches.push_back(w);
+			}
+
+			m_values.resize(m_watches.size());
+			m_answered.resize(m_watches.size());
+		}
+
+		// Frames are run one at a time: the frame after `last` is returned as soon as it is released,
+		// even if later ones are too.
+		uint64_t worker::wait_release(uint64_t last) {
+			segment_header& header = m_memory.header();
+			auto silentSince = std::chrono::steady_clock::now();
+
+			for (unsigned int round = 0; ; ++round) {
+				if (header.stopping.load(std::memory_order_acquire)) {
+					return 0;
+				}
+
+				uint64_t released = header.released.load(std::memory_order_acquire);
+
+				if (released > last) {
+					return last + 1;
+				}
+
+				if (round < spin_rounds) {
+					std::this_thread::yield();
+					continue;
+				}
+
+				if (std::chrono::steady_clock::now() - silentSince > orphan_timeout) {
+					std::cerr << "Shard " << m_index << " has not been given a frame for " << orphan_timeout.count() << " s, exiting." << std::endl;
+					return 0;
+				}
+
+				std::this_thread::sleep_for(poll_interval);
+			}
+		}
+
+		// shard_properties
+		shard_properties::shard_properties(segment& memory) :
+			m_memory(memory) { }
+
+		bool shard_properties::resolve(const std::string& entity, const std::string& property, sim::networking::property_ref& ref) {
+			uint32_t shard = shard_of(entity, m_memory.shard_count());
+			double position[3];
+			bool hasPosition;
+
+			if (!locate(shard, entity, position, hasPosition)) {
+				return false;
+			}
+
+			sim::networking::property_ref resolved;
+			resolved.entity = shard + 1;
+
+			if (property.compare(0, contacts_prefix.size(), contacts_prefix) == 0) {
+				const char* radius = property.c_str() + contacts_prefix.size();
+				char* end;
+				double value = std::strtod(radius, &end);
+
+				if (!hasPosition || end == radius || *end != '\0' || !(value >= 0.0)) {
+					return false;
+				}
+
+				m_queries.push_back(contacts_query{ entity, value });
+				resolved.index = contacts_property | static_cast<uint32_t>(m_queries.size() - 1);
+			} else {
+				resolved.index = m_memory.watch(shard, entity, property);
+
+				if (resolved.index == max_shard_watches) {
+					return false;
+				}
+			}
+
+			ref = resolved;
+			return true;
+		}
+
+		// A shard always runs the same entities, so an entity found once stays valid.
+		bool shard_properties::valid(const sim::networking::property_ref& ref) const {
+			return ref.entity != 0;
+		}
+
+		bool shard_properties::get(const sim::networking::property_ref& ref, double& value) {
+			if (ref.entity == 0) {
+				return false;
+			}
+
+			uint32_t shard = static_cast<uint32_t>(ref.entity - 1);
+
+			if (!(ref.index & contacts_property)) {
+				return m_memory.read_watch(shard, ref.index, value);
+			}
+
+			const contacts_query& query = m_queries[ref.index & ~contacts_property];
+			double position[3];
+			bool hasPosition;
+
+			if (!locate(shard, query.entity, position, hasPosition) || !hasPosition) {
+				return false;
+			}
+
+			m_memory.query_radius(position, query.radius, m_hits);
+
+			std::size_t others = 0;
+
+			for (const proximity_hit& hit : m_hits) {
+				if (hit.name != query.entity) {
+					++others;
+				}
+			}
+
+			value = static_cast<double>(others);
+			return true;
+		}
+
+		bool shard_properties::set(const sim::networking::property_ref& ref, double value) {
+			if (ref.entity == 0 || (ref.index & contacts_property)) {
+				return false;
+			}
+
+			return m_memory.push_set(static_cast<uint32_t>(ref.entity - 1), ref.index, value);
+		}
+
+		bool shard_properties::locate(uint32_t shard, const std::string& entity, double (&position)[3], bool& hasPosition) const {
+			bool found;
+
+			auto match = [&](const entity_record& rec) {
+				if (found || entity.compare(0, std::string::npos, rec.name, std::min(rec.nameLength, max_entity_name)) != 0) {
+					return;
+				}
+
+				found = true;
+				hasPosition = (rec.flags & EF_HAS_POSITION) != 0;
+
+				for (int i = 0; i < 3; ++i) {
+					position[i] = rec.position[i];
+				}
+			};
+
+			do {
+				found = false;
+				hasPosition = false;
+			} while (!m_memory.visit_latest(shard, match));
+
+			return found;
+		}
+	}
+}
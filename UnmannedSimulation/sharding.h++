@@ -0,0 +1,140 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "entity_registry.h++"
+#include "property_sessions.h++"
+#include "shard_memory.h++"
+
+namespace sim {
+	namespace sharding {
+
+		///
+		/// Runs the entities of a simulation across worker processes on this node.
+		///
+		/// Each worker owns the entities that shard_of() assigns to it, runs their physics with its own
+		/// Python interpreter and publishes their state into the shared segment every frame. The
+		/// coordinator keeps the shards in lockstep: it releases one frame at a time and only releases
+		/// the next once every ready shard has published the current one.
+		///
+		/// A worker that exits, or that has not published a frame within `frame_timeout`, is killed
+		/// and started again. The new worker restores its entities from the last frame its predecessor
+		/// published, runs every frame released since, and only then rejoins the barrier; the other
+		/// shards do not wait for it.
+		///
+		/// Frames are numbered from 1: a shard whose `completed` frame is 0 has not published any.
+		///
+
+		class coordinator {
+			public:
+				// `program` is the executable the workers are started with, normally this one.
+				coordinator(const std::string& program, uint32_t shard_count, std::chrono::milliseconds frame_timeout);
+
+				// Stops the workers and removes the shared segment.
+				virtual ~coordinator();
+
+				// Starts every worker and waits up to `timeout` for them to load their entities. Workers
+				// that take longer join the barrier once they are done.
+				void start(std::chrono::milliseconds timeout);
+
+				// Releases `frame` to the shards and waits until every ready shard has published it.
+				void run_frame(uint64_t frame);
+
+				segment&       memory()       { return m_memory; }
+				const segment& memory() const { return m_memory; }
+
+			private:
+				coordinator(const coordinator&) = delete;
+				coordinator& operator=(const coordinator&) = delete;
+
+				void spawn(uint32_t index);
+				void restart(uint32_t index, const char* reason);
+
+				// Returns true once shard `index` has published `frame`, or false once it had to be
+				// restarted (or is not ready yet) and is left out of this frame.
+				bool wait_for(uint32_t index, uint64_t frame, std::chrono::steady_clock::time_point deadline);
+
+				std::string                        m_program;
+				std::chrono::milliseconds          m_frameTimeout;
+				segment                            m_memory;
+				std::vector<boost::process::child> m_workers;
+		};
+
+		///
+		/// The frame loop of a worker process.
+		///
+
+		class worker {
+			public:
+				worker(segment& memory, uint32_t index);
+				virtual ~worker();
+
+				// Restores the entities from the shard's last published frame, if any, then runs and
+				// publishes every frame the coordinator releases until it stops the run or goes silent.
+				int run(sim::entities::registry& entities);
+
+			private:
+				struct watched {
+					sim::entities::entity_handle entity;
+					boost::python::object        key;
+				};
+
+				// Waits for the frame after `last` to be released and returns it. Returns 0 when the worker
+				// should exit.
+				uint64_t wait_release(uint64_t last);
+
+				// Applies the SETs queued for the shard, runs the physics of `frame` and publishes it.
+				void step(uint64_t frame, sim::entities::registry& entities);
+
+				// Resolves the watches the coordinator added since the last frame.
+				void update_watches(sim::entities::registry& entities);
+
+				segment&             m_memory;
+				uint32_t             m_index;
+				std::vector<watched> m_watches;
+				std::vector<double>  m_values;
+				std::vector<uint8_t> m_answered;
+		};
+
+		///
+		/// The entity properties of a sharded run, for the property sessions of its coordinator.
+		///
+		/// A property is watched by the shard that owns its entity (see segment::watch()): reads come
+		/// from the shard's latest published frame, and read as unanswered until the shard has run a
+		/// frame since it was resolved. A SET is queued for the shard, which applies it before it runs
+		/// its next frame; one its entity does not accept is dropped there. On top of what their
+		/// scripts answer for, entities that publish a position have a read-only
+		/// `contacts/<radius>` property: how many other entities, on any shard, are within `radius`
+		/// of them.
+		///
+
+		class shard_properties : public sim::networking::property_store {
+			public:
+				explicit shard_properties(segment& memory);
+
+				bool resolve(const std::string& entity, const std::string& property, sim::networking::property_ref& ref) override;
+				bool valid(const sim::networking::property_ref& ref) const override;
+				bool get(const sim::networking::property_ref& ref, double& value) override;
+				bool set(const sim::networking::property_ref& ref, double value) override;
+
+			private:
+				struct contacts_query {
+					std::string entity;
+					double      radius;
+				};
+
+				// Finds `entity` in the latest frame of `shard`. Returns false if the shard did not
+				// publish it; `hasPosition` tells whether `position` was filled.
+				bool locate(uint32_t shard, const std::string& entity, double (&position)[3], bool& hasPosition) const;
+
+				segment&                    m_memory;
+				std::vector<contacts_query> m_queries;
+				std::vector<proximity_hit>  m_hits;
+		};
+	}
+}
@@ -0,0 +1,323 @@
+#include "stdafx.h"
+
+#include "telemetry.h++"
+
+#include <cinttypes>
+#include <cstdio>
+#include <stdexcept>
+
+namespace sim {
+	namespace telemetry {
+
+		namespace detail {
+			std::atomic<bool> g_running(false);
+
+			counter_slot g_counters[static_cast<std::size_t>(counter::CT_INVALID_OUT_OF_RANGE)] = {};
+		}
+
+		namespace {
+			struct event_info {
+				const char* name;
+				const char* message;
+			};
+
+			const event_info events[] = {
+				{ "physics_step",       "Ran physics step for {text}" },
+				{ "shard_physics_step", "Ran physics step for {text} on shard {0}" },
+				{ "client_joined",      "A new client has joined the fray (connection {0})." },
+				{ "packet_read",        "Read {1} bytes from connection {0}." },
+				{ "connection_closed",  "Connection {0} closed." },
+				{ "connection_error",   "Connection {0} error {1} ({text})." },
+				{ "connection_stalled", "Connection {0} is not reading its updates, closing it." },
+				{ "legacy_message",     "process_message called: {text} ({0} bytes)" },
+				{ "session_opened",     "Property session {0} opened." },
+				{ "session_closed",     "Property session {0} closed." },
+				{ "session_truncated",  "Dropping a truncated message of property session {0}." },
+			};
+
+			static_assert(sizeof(events) / sizeof(events[0]) == static_cast<std::size_t>(event::EV_INVALID_OUT_OF_RANGE),
+				"Every event needs a name and a message.");
+
+			const char* const counter_names[] = {
+				"frames",
+				"physics_steps",
+				"commands",
+				"packets_read",
+				"bytes_read",
+				"records_dropped",
+				"lines_suppressed",
+			};
+
+			static_assert(sizeof(counter_names) / sizeof(counter_names[0]) == static_cast<std::size_t>(counter::CT_INVALID_OUT_OF_RANGE),
+				"Every counter needs a name.");
+
+			const char* const level_names[] = { "TRACE", "DEBUG", "INFO ", "WARN ", "ERROR" };
+
+			const uint64_t ns_per_second = 1000000000;
+
+			// Every ring ever handed out. A ring outlives its thread until the sink has drained it.
+			std::mutex g_ringsMutex;
+			std::vector<std::shared_ptr<ring>> g_rings;
+
+			uint64_t now() {
+				return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+			}
+
+			void append_arg(std::string& line, const record& rec, std::size_t i) {
+				char buffer[32];
+
+				if (i >= rec.argCount) {
+					return;
+				}
+
+				switch ((rec.argKinds >> (2 * i)) & 3) {
+					case AK_SIGNED:   std::snprintf(buffer, sizeof buffer, "%" PRId64, rec.args[i].i); break;
+					case AK_UNSIGNED: std::snprintf(buffer, sizeof buffer, "%" PRIu64, rec.args[i].u); break;
+					default:          std::snprintf(buffer, sizeof buffer, "%g", rec.args[i].d); break;
+				}
+
+				line += buffer;
+			}
+		}
+
+		ring& detail::local_ring() {
+			thread_local std::shared_ptr<ring> local;
+
+			if (!local) {
+				local = std::make_shared<ring>();
+
+				std::lock_guard<std::mutex> lock(g_ringsMutex);
+				g_rings.push_back(local);
+			}
+
+			return *local;
+		}
+
+		sink::sink(const std::string& path, uint32_t rate_limit, std::chrono::milliseconds drain_interval, std::chrono::seconds metrics_interval) :
+			m_out(&std::cout),
+			m_err(&std::cerr),
+			m_rateLimit(rate_limit),
+			m_drainInterval(drain_interval),
+			m_metricsInterval(metrics_interval),
+			m_start(now()),
+			m_throttles(static_cast<std::size_t>(event::EV_INVALID_OUT_OF_RANGE), throttle{ 0, 0, 0 }),
+			m_stopping(false) {
+
+			if (!path.empty()) {
+				m_file.open(path, std::ios::out | std::ios::trunc);
+
+				if (!m_file) {
+					throw std::runtime_error("could not open log file " + path);
+				}
+
+				m_out = m_err = &m_file;
+			}
+
+			m_batch.reserve(ring::capacity);
+			m_line.reserve(256);
+
+			detail::g_running.store(true);
+			m_thread = std::thread(&sink::run, this);
+		}
+
+		sink::~sink() {
+			detail::g_running.store(false);
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_stopping = true;
+			}
+
+			m_wake.notify_one();
+			m_thread.join();
+
+			// Threads that were in the middle of a log() when the sink stopped have finished by now,
+			// or will drop their record in an undrained ring; either way nothing is written concurrently.
+			drain();
+			write_metrics();
+
+			m_out->flush();
+			m_err->flush();
+		}
+
+		void sink::run() {
+			auto nextMetrics = std::chrono::steady_clock::now() + m_metricsInterval;
+			std::unique_lock<std::mutex> lock(m_mutex);
+
+			while (!m_stopping) {
+				m_wake.wait_for(lock, m_drainInterval, [this]() { return m_stopping; });
+				lock.unlock();
+
+				drain();
+
+				if (std::chrono::steady_clock::now() >= nextMetrics) {
+					write_metrics();
+					nextMetrics += m_metricsInterval;
+				}
+
+				m_out->flush();
+				m_err->flush();
+
+				lock.lock();
+			}
+		}
+
+		void sink::drain() {
+			{
+				std::lock_guard<std::mutex> lock(g_ringsMutex);
+				m_rings.assign(g_rings.begin(), g_rings.end());
+			}
+
+			m_batch.clear();
+
+			for (const auto& r : m_rings) {
+				record rec;
+
+				while (r->pop(rec)) {
+					m_batch.push_back(rec);
+				}
+			}
+
+			// Rings only meet here, so the lines of different threads are merged by time.
+			std::stable_sort(m_batch.begin(), m_batch.end(), [](const record& a, const record& b) { return a.time < b.time; });
+
+			for (const auto& rec : m_batch) {
+				write(rec);
+			}
+
+			// Sum up the events that went over their limit in a second that is over by now.
+			uint64_t current = now();
+			uint64_t second = (current - m_start) / ns_per_second;
+
+			for (std::size_t id = 0; id < m_throttles.size(); ++id) {
+				if (m_throttles[id].suppressed > 0 && m_throttles[id].second < second) {
+					write_suppressed(id, current);
+				}
+			}
+
+			// A ring only referenced from here belongs to a thread that has exited; once it is empty, it
+			// can go.
+			std::lock_guard<std::mutex> lock(g_ringsMutex);
+			m_rings.clear();
+
+			g_rings.erase(std::remove_if(g_rings.begin(), g_rings.end(), [](const std::shared_ptr<ring>& r) {
+				return r.use_count() == 1 && r->empty();
+			}), g_rings.end());
+		}
+
+		void sink::write(const record& rec) {
+			std::size_t id = static_cast<std::size_t>(rec.id);
+
+			if (id >= m_throttles.size()) {
+				return;
+			}
+
+			throttle& t = m_throttles[id];
+			uint64_t second = rec.time > m_start ? (rec.time - m_start) / ns_per_second : 0;
+
+			if (t.second != second) {
+				if (t.suppressed > 0) {
+					write_suppressed(id, rec.time);
+				}
+
+				t.second = second;
+				t.lines = 0;
+			}
+
+			if (t.lines == m_rateLimit) {
+				++t.suppressed;
+				count(counter::CT_LINES_SUPPRESSED);
+				return;
+			}
+
+			++t.lines;
+
+			begin_line(rec.time, rec.severity, events[id].name);
+
+			if (rec.entityGeneration != 0) {
+				m_line += "entity=";
+				m_line += std::to_string(rec.entityIndex);
+				m_line += ':';
+				m_line += std::to_string(rec.entityGeneration);
+				m_line += ' ';
+			}
+
+			for (const char* p = events[id].message; *p != '\0'; ++p) {
+				if (*p != '{') {
+					m_line += *p;
+					continue;
+				}
+
+				const char* close = std::strchr(p, '}');
+
+				if (close == nullptr) {
+					m_line += p;
+					break;
+				}
+
+				std::size_t length = close - p - 1;
+
+				if (length == 4 && std::strncmp(p + 1, "text", 4) == 0) {
+					m_line.append(rec.text, rec.textLength);
+				} else if (length == 6 && std::strncmp(p + 1, "entity", 6) == 0) {
+					m_line += std::to_string(rec.entityIndex);
+				} else if (length == 1 && p[1] >= '0' && p[1] <= '2') {
+					append_arg(m_line, rec, static_cast<std::size_t>(p[1] - '0'));
+				} else {
+					m_line.append(p, close + 1);
+				}
+
+				p = close;
+			}
+
+			end_line(rec.severity);
+		}
+
+		void sink::write_metrics() {
+			begin_line(now(), level::LV_INFO, "metrics");
+
+			for (std::size_t i = 0; i < static_cast<std::size_t>(counter::CT_INVALID_OUT_OF_RANGE); ++i) {
+				if (i > 0) {
+					m_line += ' ';
+				}
+
+				m_line += counter_names[i];
+				m_line += '=';
+				m_line += std::to_string(detail::g_counters[i].value.load(std::memory_order_relaxed));
+			}
+
+			end_line(level::LV_INFO);
+		}
+
+		void sink::write_suppressed(std::size_t id, uint64_t time) {
+			throttle& t = m_throttles[id];
+
+			begin_line(time, level::LV_WARN, events[id].name);
+			m_line += std::to_string(t.suppressed);
+			m_line += " more lines suppressed";
+			end_line(level::LV_WARN);
+
+			t.suppressed = 0;
+		}
+
+		void sink::begin_line(uint64_t time, level severity, const char* name) {
+			char stamp[32];
+			double seconds = time > m_start ? double(time - m_start) / ns_per_second : 0.0;
+
+			std::snprintf(stamp, sizeof stamp, "%12.6f ", seconds);
+
+			m_line.assign(stamp);
+			m_line += level_names[static_cast<std::size_t>(severity)];
+			m_line += ' ';
+			m_line += name;
+			m_line += ' ';
+		}
+
+		void sink::end_line(level severity) {
+			m_line += '\n';
+
+			std::ostream& out = severity >= level::LV_WARN ? *m_err : *m_out;
+			out.write(m_line.data(), m_line.size());
+		}
+	}
+}
@@ -0,0 +1,361 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "entity_registry.h++"
+
+///
+/// Compile-time log level. Records below SIM_LOG_LEVEL are compiled out: their macros expand to
+/// nothing and their arguments are never evaluated. Debug builds default to debug, release builds to
+/// info; define SIM_LOG_LEVEL to override.
+///
+
+#define SIM_LOG_LEVEL_TRACE 0
+#define SIM_LOG_LEVEL_DEBUG 1
+#define SIM_LOG_LEVEL_INFO  2
+#define SIM_LOG_LEVEL_WARN  3
+#define SIM_LOG_LEVEL_ERROR 4
+#define SIM_LOG_LEVEL_OFF   5
+
+#ifndef SIM_LOG_LEVEL
+#ifdef _DEBUG
+#define SIM_LOG_LEVEL SIM_LOG_LEVEL_DEBUG
+#else
+#define SIM_LOG_LEVEL SIM_LOG_LEVEL_INFO
+#endif
+#endif
+
+#if SIM_LOG_LEVEL <= SIM_LOG_LEVEL_TRACE
+#define SIM_TRACE(...) ::sim::telemetry::log(::sim::telemetry::level::LV_TRACE, __VA_ARGS__)
+#else
+#define SIM_TRACE(...) ((void)0)
+#endif
+
+#if SIM_LOG_LEVEL <= SIM_LOG_LEVEL_DEBUG
+#define SIM_DEBUG(...) ::sim::telemetry::log(::sim::telemetry::level::LV_DEBUG, __VA_ARGS__)
+#else
+#define SIM_DEBUG(...) ((void)0)
+#endif
+
+#if SIM_LOG_LEVEL <= SIM_LOG_LEVEL_INFO
+#define SIM_INFO(...) ::sim::telemetry::log(::sim::telemetry::level::LV_INFO, __VA_ARGS__)
+#else
+#define SIM_INFO(...) ((void)0)
+#endif
+
+#if SIM_LOG_LEVEL <= SIM_LOG_LEVEL_WARN
+#define SIM_WARN(...) ::sim::telemetry::log(::sim::telemetry::level::LV_WARN, __VA_ARGS__)
+#else
+#define SIM_WARN(...) ((void)0)
+#endif
+
+#if SIM_LOG_LEVEL <= SIM_LOG_LEVEL_ERROR
+#define SIM_ERROR(...) ::sim::telemetry::log(::sim::telemetry::level::LV_ERROR, __VA_ARGS__)
+#else
+#define SIM_ERROR(...) ((void)0)
+#endif
+
+namespace sim {
+	namespace telemetry {
+
+		enum class level : uint8_t
+		{
+			LV_TRACE = SIM_LOG_LEVEL_TRACE,
+			LV_DEBUG = SIM_LOG_LEVEL_DEBUG,
+			LV_INFO  = SIM_LOG_LEVEL_INFO,
+			LV_WARN  = SIM_LOG_LEVEL_WARN,
+			LV_ERROR = SIM_LOG_LEVEL_ERROR
+		};
+
+		///
+		/// Log events. Each has a name and a message template in telemetry.c++, where `{text}`,
+		/// `{entity}` and `{0}` to `{2}` are replaced by the fields of the record.
+		///
+
+		enum class event : uint16_t
+		{
+			EV_PHYSICS_STEP = 0,        // text: entity name
+			EV_SHARD_PHYSICS_STEP,      // text: entity name, 0: shard
+			EV_CLIENT_JOINED,           // 0: session
+			EV_PACKET_READ,             // 0: session, 1: bytes
+			EV_CONNECTION_CLOSED,       // 0: session
+			EV_CONNECTION_ERROR,        // text: error category, 0: session, 1: error code
+			EV_CONNECTION_STALLED,      // 0: session
+			EV_LEGACY_MESSAGE,          // text: start of the message, 0: bytes
+			EV_SESSION_OPENED,          // 0: session
+			EV_SESSION_CLOSED,          // 0: session
+			EV_SESSION_TRUNCATED,       // 0: session
+			EV_INVALID_OUT_OF_RANGE
+		};
+
+		///
+		/// Hot counters. They are exported as one metrics line per interval instead of a line per
+		/// occurrence.
+		///
+
+		enum class counter : uint16_t
+		{
+			CT_FRAMES = 0,
+			CT_PHYSICS_STEPS,
+			CT_COMMANDS,
+			CT_PACKETS_READ,
+			CT_BYTES_READ,
+			CT_RECORDS_DROPPED,         // a thread's ring was full
+			CT_LINES_SUPPRESSED,        // over an event's rate limit
+			CT_INVALID_OUT_OF_RANGE
+		};
+
+		///
+		/// A log record: one cache line, copied as is into a ring and formatted by the drain thread.
+		/// Text longer than `max_text` is truncated.
+		///
+
+		struct record {
+			static const std::size_t max_args = 3;
+			static const std::size_t max_text = 16;
+
+			uint64_t time;              // steady clock, in nanoseconds
+			uint32_t entityIndex;
+			uint32_t entityGeneration;  // 0: no entity
+			event    id;
+			level    severity;
+			uint8_t  argKinds;          // 2 bits per argument, see arg_kind
+			uint8_t  argCount;
+			uint8_t  textLength;
+			uint8_t  reserved[2];
+			union {
+				int64_t  i;
+				uint64_t u;
+				double   d;
+			}        args[max_args];
+			char     text[max_text];
+		};
+
+		static_assert(sizeof(record) == 64, "A telemetry record is meant to fill one cache line.");
+
+		enum arg_kind : uint8_t { AK_SIGNED = 0, AK_UNSIGNED, AK_REAL };
+
+		///
+		/// Single-producer, single-consumer ring of records. The owning thread pushes, the drain thread
+		/// pops; neither ever blocks, and a push into a full ring fails.
+		///
+
+		class ring {
+			public:
+				static const std::size_t capacity = 1024;
+
+				ring() : m_head(0), m_tail(0) { }
+
+				bool push(const record& rec) {
+					std::size_t head = m_head.load(std::memory_order_relaxed);
+
+					if (head - m_tail.load(std::memory_order_acquire) == capacity) {
+						return false;
+					}
+
+					m_records[head & (capacity - 1)] = rec;
+					m_head.store(head + 1, std::memory_order_release);
+					return true;
+				}
+
+				bool pop(record& rec) {
+					std::size_t tail = m_tail.load(std::memory_order_relaxed);
+
+					if (tail == m_head.load(std::memory_order_acquire)) {
+						return false;
+					}
+
+					rec = m_records[tail & (capacity - 1)];
+					m_tail.store(tail + 1, std::memory_order_release);
+					return true;
+				}
+
+				bool empty() const {
+					return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_acquire);
+				}
+
+			private:
+				static_assert((capacity & (capacity - 1)) == 0, "The ring capacity must be a power of two.");
+
+				// The indices are kept a cache line apart, so that the two threads do not contend for one.
+				std::atomic<std::size_t> m_head;
+				char                     m_headPadding[64 - sizeof(std::atomic<std::size_t>)];
+				std::atomic<std::size_t> m_tail;
+				char                     m_tailPadding[64 - sizeof(std::atomic<std::size_t>)];
+				record                   m_records[capacity];
+		};
+
+		///
+		/// Text passed by pointer and length, for text that is not a std::string or not terminated.
+		///
+
+		struct text_ref {
+			const char* data;
+			std::size_t length;
+		};
+
+		namespace detail {
+			// Whether a sink is running. Without one, records are not even built.
+			extern std::atomic<bool> g_running;
+
+			struct alignas(64) counter_slot {
+				std::atomic<uint64_t> value;
+			};
+
+			extern counter_slot g_counters[static_cast<std::size_t>(counter::CT_INVALID_OUT_OF_RANGE)];
+
+			// The calling thread's ring, registered with the sink on first use.
+			ring& local_ring();
+
+			inline void put(record& rec, sim::entities::entity_handle entity) {
+				rec.entityIndex = entity.index;
+				rec.entityGeneration = entity.generation;
+			}
+
+			inline void put(record& rec, const char* text, std::size_t length) {
+				length = std::min(length, sizeof(rec.text));
+				std::memcpy(rec.text, text, length);
+				rec.textLength = static_cast<uint8_t>(length);
+			}
+
+			inline void put(record& rec, text_ref text)           { put(rec, text.data, text.length); }
+			inline void put(record& rec, const char* text)        { put(rec, text, std::strlen(text)); }
+			inline void put(record& rec, const std::string& text) { put(rec, text.data(), text.size()); }
+
+			template <typename T>
+			typename std::enable_if<std::is_arithmetic<T>::value>::type put(record& rec, T value) {
+				if (rec.argCount == record::max_args) {
+					return;
+				}
+
+				uint8_t kind;
+
+				if (std::is_floating_point<T>::value) {
+					rec.args[rec.argCount].d = static_cast<double>(value);
+					kind = AK_REAL;
+				} else if (std::is_signed<T>::value) {
+					rec.args[rec.argCount].i = static_cast<int64_t>(value);
+					kind = AK_SIGNED;
+				} else {
+					rec.args[rec.argCount].u = static_cast<uint64_t>(value);
+					kind = AK_UNSIGNED;
+				}
+
+				rec.argKinds |= kind << (2 * rec.argCount);
+				++rec.argCount;
+			}
+		}
+
+		///
+		/// Appends a record to the calling thread's ring. Arguments are taken in any order: an
+		/// entity_handle, at most one string, and up to three numbers, in the order of the event's
+		/// template. Never blocks: if the drain thread has fallen behind, the record is dropped and
+		/// counted. Use the SIM_* macros rather than calling this directly.
+		///
+
+		template <typename... Args>
+		void log(level severity, event id, const Args&... args) {
+			if (!detail::g_running.load(std::memory_order_relaxed)) {
+				return;
+			}
+
+			record rec;
+			rec.time = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+			rec.entityIndex = 0;
+			rec.entityGeneration = 0;
+			rec.id = id;
+			rec.severity = severity;
+			rec.argKinds = 0;
+			rec.argCount = 0;
+			rec.textLength = 0;
+
+			int expand[] = { 0, (detail::put(rec, args), 0)... };
+			(void)expand;
+
+			if (!detail::local_ring().push(rec)) {
+				detail::g_counters[static_cast<std::size_t>(counter::CT_RECORDS_DROPPED)].value.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
+		inline void count(counter id, uint64_t n = 1) {
+			detail::g_counters[static_cast<std::size_t>(id)].value.fetch_add(n, std::memory_order_relaxed);
+		}
+
+		///
+		/// Drains every thread's ring on a background thread and writes the records as text lines, to
+		/// the console or to a file.
+		///
+		/// Records from all threads are merged in time order every drain interval. Each event is
+		/// limited to `rate_limit` lines per second; the lines over the limit are dropped and summed
+		/// up once the second is over. The counters are written as one `metrics` line every metrics
+		/// interval, and once more when the sink stops.
+		///
+		/// There is one sink per process: log() is a no-op until it is started and after it is
+		/// destroyed.
+		///
+
+		class sink {
+			public:
+				// Writes to the console if `path` is empty: warnings and errors to the error stream, the
+				// rest to the standard output.
+				explicit sink(const std::string& path = std::string(),
+					uint32_t rate_limit = 20,
+					std::chrono::milliseconds drain_interval = std::chrono::milliseconds(50),
+					std::chrono::seconds metrics_interval = std::chrono::seconds(10));
+
+				// Drains what is left and writes the final metrics.
+				virtual ~sink();
+
+			private:
+				sink(const sink&) = delete;
+				sink& operator=(const sink&) = delete;
+
+				struct throttle {
+					uint64_t second;
+					uint32_t lines;
+					uint64_t suppressed;
+				};
+
+				void run();
+				void drain();
+				void write(const record& rec);
+				void write_metrics();
+				void write_suppressed(std::size_t id, uint64_t time);
+				void begin_line(uint64_t time, level severity, const char* name);
+				void end_line(level severity);
+
+				std::ofstream                             m_file;
+				std::ostream*                             m_out;
+				std::ostream*                             m_err;         // warnings and errors
+				uint32_t                                  m_rateLimit;
+				std::chrono::milliseconds                 m_drainInterval;
+				std::chrono::seconds                      m_metricsInterval;
+				uint64_t                                  m_start;
+
+				std::vector<std::shared_ptr<ring>>        m_rings;
+				std::vector<record>                       m_batch;
+				std::vector<throttle>                     m_throttles;
+				std::string                               m_line;
+
+				std::mutex                                m_mutex;
+				std::condition_variable                   m_wake;
+				bool                                      m_stopping;
+				std::thread                               m_thread;
+		};
+	}
+}
@@ -49,6 +49,7 @@ INCLUDES
 #include "models/FGPropagate.h"
 #include "math/FGColumnVector3.h"
 #include "models/FGOutput.h"
+#include "input_output/FGProfiler.h"
 
 /*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 DEFINITIONS
@@ -67,6 +68,7 @@ class FGTrim;
 class FGAerodynamics;
 class FGAircraft;
 class FGAtmosphere;
+class FGEnvironment;
 class FGAccelerations;
 class FGWinds;
 class FGAuxiliary;
@@ -171,6 +173,65 @@ CLASS DOCUMENTATION
        a message is printed out when they go out of bounds
 
     <h3>Properties</h3>
+    When JSBSim is built with JSBSIM_PROFILING defined, each executive
+    instance owns an FGProfiler that times every frame, every model Run() and
+    LoadInputs() call, the script, the FCS channels and the top-level
+    aerodynamic functions. The statistics are published under profiling/.
+
+    <h3>Sleeping</h3>
+    A vehicle that is parked or landed costs as much per frame as a flying one
+    unless it is allowed to sleep. When simulation/sleep/enabled is set, the
+    executive checks after each frame whether the vehicle has settled: every
+    bogey has weight on wheels, the body velocities, rates and accelerations
+    are below their thresholds, no engine is starting or running above idle
+    throttle, and no script event is still transiting. Once it has stayed
+    settled for simulation/sleep/settle-time-sec, the executive falls asleep:
+    its frames then only advance the time and run the script, the input, the
+    atmosphere, the winds and the output. The equations of motion are not
+    integrated: FGPropagate::RunAtRest() keeps the location, attitude, velocity
+    and rates of the vehicle relative to the Earth, and only turns it with the
+    planet, so that the Earth position angle keeps up with the time. A run that
+    slept does not end bit-identical to one that stayed awake, since the
+    residual motion of the settled vehicle is dropped while it sleeps.
+
+    A sleeping executive wakes up when any of its properties is written (an
+    inbound command, a script event, a reset), when the total wind or the
+    density change by more than their thresholds since it fell asleep, or when
+    Wake() is called, for instance by a collision handler. The models it skipped
+    run again from the frame it wakes up in. The past derivatives of the
+    integrators are reset when it wakes up, and primed again from the
+    accelerations of the first frame the vehicle is awake for, as after the
+    initial conditions. GetSleepStatistics() reports how many executives of
+    the process are awake and asleep and the CPU time saved. The saving is
+    estimated from the thread CPU time of one frame in 32, averaged over every
+    frame sampled awake and asleep, so that time spent descheduled does not
+    count.
+
+    A vehicle only sleeps if the integrators let it come to rest. With the
+    Adams-Bashforth 3 integrator (value 4) for the translational and rotational
+    rates and positions, a parked c172x is left in a limit cycle on its stiff
+    gear: its body accelerations swing by about 14 ft/s^2 from one frame to the
+    next, and it creeps at about 0.17 ft/s. That is above the velocity
+    threshold, so it never settles and never sleeps. This is real, if
+    spurious, motion, and it is not hidden by raising the thresholds. Use the
+    default integrators, or rectangular Euler, for vehicles that are expected
+    to sleep.
+
+    @property simulation/sleep/enabled (read/write) allows the vehicle to sleep
+    @property simulation/sleep/asleep (read only) true while the vehicle sleeps
+    @property simulation/sleep/frames-slept (read only) frames skipped so far
+    @property simulation/sleep/settle-time-sec (read/write) time the vehicle
+                                has to stay settled before it falls asleep
+    @property simulation/sleep/velocity-threshold-fps (read/write)
+    @property simulation/sleep/rate-threshold-rad_sec (read/write)
+    @property simulation/sleep/acceleration-threshold-ft_sec2 (read/write)
+    @property simulation/sleep/idle-throttle (read/write) throttle position,
+                                as a fraction of its range, up to which a
+                                running engine is considered idle
+    @property simulation/sleep/wind-threshold-fps (read/write)
+    @property simulation/sleep/density-threshold (read/write) relative
+                                density change that wakes the vehicle
+
     @property simulator/do_trim (write only) Can be set to the integer equivalent to one of
                                 tLongitudinal (0), tFull (1), tGround (2), tPullup (3),
                                 tCustom (4), tTurn (5). Setting this to a legal value
@@ -187,6 +248,8 @@ CLASS DECLARATION
 
 class FGFDMExec : public FGJSBBase
 {
+  class WakeListener;
+
   struct childData {
     FGFDMExec* exec;
     std::string info;
@@ -248,6 +311,19 @@ public:
                  eOutput,
                  eNumStandardModels };
 
+  /// Quiescence counters summed over the executives of the process that have
+  /// sleeping enabled.
+  struct SleepStatistics {
+    /// Number of executives running every model.
+    unsigned int Awake;
+    /// Number of executives asleep.
+    unsigned int Asleep;
+    /// Total number of frames run asleep.
+    unsigned long long FramesSlept;
+    /// Estimated CPU time saved by the frames run asleep, in seconds.
+    double CPUSaved;
+  };
+
   /** Unbind all tied JSBSim properties. */
   void Unbind(void) {instance->Unbind();}
 
@@ -269,6 +345,16 @@ public:
    */
   void SetGroundCallback(FGGroundCallback* gc) { FGLocation::SetGroundCallback(gc); }
 
+  /** Attaches an environment shared with other FDMs, or detaches it when
+      null. While attached, the atmosphere is looked up in the environment's
+      precomputed tables and the ttField turbulence model samples its
+      turbulence field. The environment is not owned by the executive and
+      must outlive it. Child FDMs use the environment of their parent.
+      @param env the environment, typically FGEnvironment::GetShared().
+      @see FGEnvironment
+   */
+  void SetEnvironment(FGEnvironment* env);
+
   /** Loads an aircraft model.
       @param AircraftPath path to the aircraft/ directory. For instance:
       "aircraft". Under aircraft, then, would be directories for various
@@ -375,6 +461,12 @@ public:
   FGInitialCondition* GetIC(void)      {return IC;}
   /// Returns a pointer to the FGTrim object
   FGTrim* GetTrim(void);
+  /// Returns the attached environment, or null if there is none.
+  FGEnvironment* GetEnvironment(void) const {return Environment;}
+#ifdef JSBSIM_PROFILING
+  /// Returns the profiler that times the executive hot paths.
+  FGProfiler* GetProfiler(void)        {return Profiler;}
+#endif
   ///@}
 
   /// Retrieves the engine path.
@@ -470,6 +562,11 @@ public:
   void DisableOutput(void) { Output->Disable(); }
   /// Enables data logging to all outputs.
   void EnableOutput(void) { Output->Enable(); }
+  /** Makes the models loaded from then on skip their <input> and <output>
+      elements, so that a headless run opens none of their sockets or files. */
+  void SetIODirectivesEnabled(bool enabled) {IODirectivesEnabled = enabled;}
+  /// Returns true if the <input> and <output> elements are loaded.
+  bool GetIODirectivesEnabled(void) const {return IODirectivesEnabled;}
   /// Pauses execution by preventing time from incrementing.
   void Hold(void) {holding = true;}
   /// Turn on hold after increment
@@ -480,6 +577,28 @@ public:
   void Resume(void) {holding = false;}
   /// Returns true if the simulation is Holding (i.e. simulation time is not moving).
   bool Holding(void) {return holding;}
+  /// Allows or forbids the vehicle to sleep once settled. Forbidding it wakes the vehicle up.
+  void SetSleepEnabled(bool enabled);
+  /// Returns true if the vehicle is allowed to sleep.
+  bool GetSleepEnabled(void) const {return Sleep.Enabled;}
+  /// Returns true while the vehicle sleeps.
+  bool Asleep(void) const {return Sleep.Asleep;}
+  /** Wakes up a sleeping vehicle at the start of its next frame, for events
+      that are not seen through the property tree such as collisions. */
+  void Wake(void) {Sleep.WakeRequested = true;}
+  /// Returns the quiescence counters of all the executives of the process.
+  static SleepStatistics GetSleepStatistics(void);
+  /** Turns the sampled model timing on or off. While it is on, each model's
+      Run() is timed on one frame out of 32 with the wall clock, which costs
+      little enough to leave it on in a measured run. Turning it on again
+      restarts the measurement. Unlike the JSBSIM_PROFILING build, it is always
+      compiled in. */
+  void SetModelTiming(bool enabled);
+  /** Returns the mean time, in nanoseconds, that a model took per frame since
+      the model timing was turned on. A model skipped on a frame, as while the
+      vehicle sleeps, counts as taking no time on it.
+      @param model index of the model, from the eModels enum */
+  double GetModelNsPerFrame(unsigned int model) const;
   /** Resets the initial conditions object and prepares the simulation to run
       again. If mode is set to 1 the output instances will take special actions
       such as closing the current output file and open a new one with a
@@ -599,6 +718,7 @@ private:
   bool Constructing;
   bool modelLoaded;
   bool IsChild;
+  bool IODirectivesEnabled;
   std::string modelName;
   std::string AircraftPath;
   std::string FullAircraftPath;
@@ -633,6 +753,46 @@ private:
   FGScript*           Script;
   FGInitialCondition* IC;
   FGTrim*             Trim;
+  FGEnvironment*      Environment;
+
+#ifdef JSBSIM_PROFILING
+  FGProfiler*         Profiler;
+  int                 FrameSlot;
+  int                 ScriptSlot;
+  std::vector <int>   ModelSlots;
+  std::vector <int>   InputSlots;
+#endif
+
+  bool ModelTiming;
+  unsigned int ModelTimingCounter;
+  unsigned long long ModelTimingSamples;
+  std::vector <double> ModelTimes;
+
+  struct sleepData {
+    bool Enabled;
+    bool Asleep;
+    bool WakeRequested;
+    bool PrimeDerivatives;
+    double SettledSince;
+    double SettleTime;
+    double VelocityThreshold;
+    double RateThreshold;
+    double AccelerationThreshold;
+    double IdleThrottle;
+    double WindThreshold;
+    double DensityThreshold;
+    FGColumnVector3 WindNED;
+    double Density;
+    unsigned long long FramesSlept;
+    unsigned int UnreportedFrames;
+    unsigned int SampleCounter;
+    double AwakeCPUTime;
+    double AsleepCPUTime;
+    unsigned int AwakeSamples;
+    unsigned int AsleepSamples;
+  } Sleep;
+
+  WakeListener* SleepListener;
 
   FGPropertyManager* Root;
   bool StandAlone;
@@ -655,6 +815,13 @@ private:
   bool Allocate(void);
   bool DeAllocate(void);
   int GetDisperse(void) const {return disperse;}
+  double GetFramesSlept(void) const {return (double)Sleep.FramesSlept;}
+  bool Settled(void) const;
+  void CheckQuiescence(void);
+  void FallAsleep(void);
+  void WakeUp(void);
+  void ReportSleep(void);
+  void RecordFrameCost(double seconds, bool asleep);
 
   void Debug(int from);
 };
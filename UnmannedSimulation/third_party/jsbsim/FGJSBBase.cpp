@@ -41,6 +41,7 @@ INCLUDES
 #include <iostream>
 #include <sstream>
 #include <cstdlib>
+#include <mutex>
 
 using namespace std;
 
@@ -110,8 +111,57 @@ const double FGJSBBase::kgtoslug = 0.06852168;
 const string FGJSBBase::needed_cfg_version = "2.0";
 const string FGJSBBase::JSBSim_version = "1.0 " __DATE__ " " __TIME__ ;
 
-queue <FGJSBBase::Message> FGJSBBase::Messages;
-FGJSBBase::Message FGJSBBase::localMsg;
+// The message queue is shared by every FDM of the process, which may be run
+// from different threads.
+static mutex MessageLock;
+
+// Serializes ProcessMessage() callers, which share PrintedMsg. It is never
+// taken while MessageLock is held.
+static mutex PrintLock;
+
+// Message slots are given room for a typical message up front, so that the
+// first use of a slot does not allocate either.
+static const string::size_type MessageTextReserve = 128;
+
+// Number of messages the queue holds before it starts dropping the oldest.
+static const unsigned int MessageRingSize = 64;
+
+static FGJSBBase::Message NewMessage(void)
+{
+  FGJSBBase::Message msg;
+  msg.text.reserve(MessageTextReserve);
+  return msg;
+}
+
+static vector <FGJSBBase::Message> NewMessageRing(unsigned int size)
+{
+  vector <FGJSBBase::Message> ring(size);
+  for (unsigned int i=0; i<size; i++) ring[i].text.reserve(MessageTextReserve);
+  return ring;
+}
+
+// Moves a queued message into a caller's buffer. The strings are swapped so
+// that both the slot and the buffer keep their capacity. MessageLock must be
+// held.
+static void TakeMessage(FGJSBBase::Message& slot, FGJSBBase::Message& msg)
+{
+  msg.fdmId = slot.fdmId;
+  msg.messageId = slot.messageId;
+  msg.text.swap(slot.text);
+  msg.subsystem.swap(slot.subsystem);
+  msg.type = slot.type;
+  msg.bVal = slot.bVal;
+  msg.iVal = slot.iVal;
+  msg.dVal = slot.dVal;
+}
+
+static FGJSBBase::Message PrintedMsg = NewMessage();
+
+FGJSBBase::Message FGJSBBase::localMsg = NewMessage();
+vector <FGJSBBase::Message> FGJSBBase::Messages = NewMessageRing(MessageRingSize);
+unsigned int FGJSBBase::MessageHead = 0;
+unsigned int FGJSBBase::MessageCount = 0;
+unsigned int FGJSBBase::DroppedMessages = 0;
 unsigned int FGJSBBase::messageId = 0;
 
 int FGJSBBase::gaussian_random_number_phase = 0;
@@ -120,107 +170,144 @@ short FGJSBBase::debug_lvl  = 1;
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 
+// Returns the slot following the last queued message, dropping the oldest one
+// when the ring is full. MessageLock must be held.
+
+FGJSBBase::Message& FGJSBBase::NextMessageSlot(void)
+{
+  if (MessageCount == MessageRingSize) {
+    PopMessage();
+    DroppedMessages++;
+  }
+
+  return Messages[(MessageHead + MessageCount++) % MessageRingSize];
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
 void FGJSBBase::PutMessage(const Message& msg)
 {
-  Messages.push(msg);
+  lock_guard<mutex> guard(MessageLock);
+  NextMessageSlot() = msg;
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 
 void FGJSBBase::PutMessage(const string& text)
 {
-  Message msg;
+  lock_guard<mutex> guard(MessageLock);
+  Message& msg = NextMessageSlot();
   msg.text = text;
   msg.messageId = messageId++;
   msg.subsystem = "FDM";
   msg.type = Message::eText;
-  Messages.push(msg);
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 
 void FGJSBBase::PutMessage(const string& text, bool bVal)
 {
-  Message msg;
+  lock_guard<mutex> guard(MessageLock);
+  Message& msg = NextMessageSlot();
   msg.text = text;
   msg.messageId = messageId++;
   msg.subsystem = "FDM";
   msg.type = Message::eBool;
   msg.bVal = bVal;
-  Messages.push(msg);
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 
 void FGJSBBase::PutMessage(const string& text, int iVal)
 {
-  Message msg;
+  lock_guard<mutex> guard(MessageLock);
+  Message& msg = NextMessageSlot();
   msg.text = text;
   msg.messageId = messageId++;
   msg.subsystem = "FDM";
   msg.type = Message::eInteger;
   msg.iVal = iVal;
-  Messages.push(msg);
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 
 void FGJSBBase::PutMessage(const string& text, double dVal)
 {
-  Message msg;
+  lock_guard<mutex> guard(MessageLock);
+  Message& msg = NextMessageSlot();
   msg.text = text;
   msg.messageId = messageId++;
   msg.subsystem = "FDM";
   msg.type = Message::eDouble;
   msg.dVal = dVal;
-  Messages.push(msg);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+int FGJSBBase::SomeMessages(void)
+{
+  lock_guard<mutex> guard(MessageLock);
+  return MessageCount != 0;
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 
 void FGJSBBase::ProcessMessage(void)
 {
-  if (Messages.empty()) return;
-  localMsg = Messages.front();
-
-  while (SomeMessages()) {
-      switch (localMsg.type) {
-      case JSBSim::FGJSBBase::Message::eText:
-        cout << localMsg.messageId << ": " << localMsg.text << endl;
-        break;
-      case JSBSim::FGJSBBase::Message::eBool:
-        cout << localMsg.messageId << ": " << localMsg.text << " " << localMsg.bVal << endl;
-        break;
-      case JSBSim::FGJSBBase::Message::eInteger:
-        cout << localMsg.messageId << ": " << localMsg.text << " " << localMsg.iVal << endl;
-        break;
-      case JSBSim::FGJSBBase::Message::eDouble:
-        cout << localMsg.messageId << ": " << localMsg.text << " " << localMsg.dVal << endl;
-        break;
-      default:
-        cerr << "Unrecognized message type." << endl;
-        break;
-      }
-      Messages.pop();
-      if (SomeMessages()) localMsg = Messages.front();
-      else break;
+  // Each message is moved out of its slot under MessageLock and printed once
+  // that lock is released.
+  lock_guard<mutex> print(PrintLock);
+  while (ProcessNextMessage(PrintedMsg)) {
+    switch (PrintedMsg.type) {
+    case JSBSim::FGJSBBase::Message::eText:
+      cout << PrintedMsg.messageId << ": " << PrintedMsg.text << endl;
+      break;
+    case JSBSim::FGJSBBase::Message::eBool:
+      cout << PrintedMsg.messageId << ": " << PrintedMsg.text << " " << PrintedMsg.bVal << endl;
+      break;
+    case JSBSim::FGJSBBase::Message::eInteger:
+      cout << PrintedMsg.messageId << ": " << PrintedMsg.text << " " << PrintedMsg.iVal << endl;
+      break;
+    case JSBSim::FGJSBBase::Message::eDouble:
+      cout << PrintedMsg.messageId << ": " << PrintedMsg.text << " " << PrintedMsg.dVal << endl;
+      break;
+    default:
+      cerr << "Unrecognized message type." << endl;
+      break;
+    }
   }
-
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 
 FGJSBBase::Message* FGJSBBase::ProcessNextMessage(void)
 {
-  if (Messages.empty()) return NULL;
-  localMsg = Messages.front();
-
-  Messages.pop();
+  if (!ProcessNextMessage(localMsg)) return NULL;
   return &localMsg;
 }
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 
+bool FGJSBBase::ProcessNextMessage(Message& msg)
+{
+  lock_guard<mutex> guard(MessageLock);
+  if (MessageCount == 0) return false;
+  TakeMessage(Messages[MessageHead], msg);
+
+  PopMessage();
+  return true;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+unsigned int FGJSBBase::GetDroppedMessages(void)
+{
+  lock_guard<mutex> guard(MessageLock);
+  return DroppedMessages;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
 void FGJSBBase::disableHighLighting(void)
 {
   highint[0]='\0';
@@ -81,6 +81,7 @@ string RootDir = "";
 string ScriptName;
 string AircraftName;
 string ResetName;
+string ProfileName;
 vector <string> LogOutputName;
 vector <string> LogDirectiveName;
 vector <string> CommandLineProperties;
@@ -296,6 +297,7 @@ int real_main(int argc, char* argv[])
   ScriptName = "";
   AircraftName = "";
   ResetName = "";
+  ProfileName = "";
   LogOutputName.clear();
   LogDirectiveName.clear();
   bool result = false, success;
@@ -337,6 +339,10 @@ int real_main(int argc, char* argv[])
 
   if (nohighlight) FDMExec->disableHighLighting();
 
+#ifdef JSBSIM_PROFILING
+  if (!ProfileName.empty()) FDMExec->GetProfiler()->SetTracing(true);
+#endif
+
   if (simulation_rate < 1.0 )
     FDMExec->Setdt(simulation_rate);
   else
@@ -535,6 +541,14 @@ quit:
   strftime(s, 99, "%A %B %d %Y %X", localtime(&tod));
   cout << "End: " << s << " (HH:MM:SS)" << endl;
 
+#ifdef JSBSIM_PROFILING
+  if (!ProfileName.empty()) {
+    cout << FDMExec->GetProfiler()->GetReport();
+    if (!JSBSim::FGProfiler::WriteChromeTrace(ProfileName))
+      cerr << "Could not write the profile trace to " << ProfileName << endl;
+  }
+#endif
+
   // CLEAN UP
   delete FDMExec;
 
@@ -676,6 +690,18 @@ bool options(int count, char **arg)
         exit(1);
       }
 
+    } else if (keyword == "--profile") {
+#ifdef JSBSIM_PROFILING
+      if (n != string::npos) {
+        ProfileName = value;
+      } else {
+        gripe;
+        exit(1);
+      }
+#else
+      cerr << "This JSBSim was built without JSBSIM_PROFILING; --profile is ignored" << endl;
+#endif
+
     } else if (keyword == "--catalog") {
         catalog = true;
         if (value.size() > 0) AircraftName=value;
@@ -749,7 +775,9 @@ void PrintHelp(void)
     cout << "    --simulation-rate=<rate (double)> specifies the sim dT time or frequency" << endl;
     cout << "                      If rate specified is less than 1, it is interpreted as" << endl;
     cout << "                      a time step size, otherwise it is assumed to be a rate in Hertz." << endl;
-    cout << "    --end=<time (double)> specifies the sim end time" << endl << endl;
+    cout << "    --end=<time (double)> specifies the sim end time" << endl;
+    cout << "    --profile=<filename>  prints a timing report at the end of the run and writes" << endl;
+    cout << "                          a Chrome trace (requires a JSBSIM_PROFILING build)" << endl << endl;
 
     cout << "  NOTE: There can be no spaces around the = sign when" << endl;
     cout << "        an option is followed by a filename" << endl << endl;
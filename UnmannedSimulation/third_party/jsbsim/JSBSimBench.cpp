@@ -0,0 +1,827 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+ Module:       JSBSimBench.cpp
+ Date started: 10/18/26
+ Purpose:      Reproducible performance benchmark of the JSBSim executive.
+ Called by:    The USER, or the "benchmark" build target.
+
+ ------------- Copyright (C) 2026 -------------
+
+ This program is free software; you can redistribute it and/or modify it under
+ the terms of the GNU Lesser General Public License as published by the Free Software
+ Foundation; either version 2 of the License, or (at your option) any later
+ version.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ details.
+
+ You should have received a copy of the GNU Lesser General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ Place - Suite 330, Boston, MA  02111-1307, USA.
+
+ Further information about the GNU Lesser General Public License can also be found on
+ the world wide web at http://www.gnu.org.
+
+FUNCTIONAL DESCRIPTION
+--------------------------------------------------------------------------------
+
+Runs a fixed matrix of cases (aircraft or script x integrator x thread count)
+headless and in batch mode, and reports for each case:
+
+- frames per second, summed over all threads
+- allocations per frame, counted by replacing the global operator new
+- peak resident memory of the process while the case ran
+- nanoseconds per model per frame, from the sampled model timing of FGFDMExec
+
+The matrix is read from an XML file (see benchmarks/matrix.xml). Each case
+may be repeated, in which case the fastest run is reported. Measurements start
+after a warmup period of simulated time; cases given a "max-allocs" limit fail
+the run when their frame loop allocates more than that, which is how the
+zero allocation steady state of FGFDMExec::Run() is checked. Results are written
+as JSON, one case per line, and can be compared against a baseline file
+produced by a previous run. The program exits with a non zero status when a
+case allocates more than the baseline allows. The frames per second are tied
+to the machine the baseline was recorded on and are only reported next to the
+baseline's, not checked.
+
+With --shared-environment, every FDM is attached to the process-wide
+FGEnvironment, and the case identifiers get a "/shared-env" suffix so that
+such runs are only compared against baselines made the same way.
+
+With --sleep, every FDM is allowed to sleep once its vehicle has settled (see
+FGFDMExec) and the identifiers get a "/sleep" suffix. Each result then also
+reports how many of the case's FDMs were asleep at the end of the run, the
+frames they slept and the CPU time the executives estimate this saved.
+With --both, the whole matrix is run without and then with sleeping, and the
+two sets of results are written together, which is the form of the stored
+baseline.
+
+HISTORY
+--------------------------------------------------------------------------------
+10/18/26          Created
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include "FGFDMExec.h"
+#include "initialization/FGInitialCondition.h"
+#include "input_output/FGXMLFileRead.h"
+#include "input_output/FGXMLElement.h"
+#include "models/atmosphere/FGEnvironment.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#  include <psapi.h>
+#elif defined(__APPLE__)
+#  include <mach/mach.h>
+#endif
+#if defined(__GLIBC__)
+#  include <malloc.h>
+#endif
+
+using namespace std;
+using JSBSim::FGXMLFileRead;
+using JSBSim::Element;
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+GLOBAL DATA
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+string RootDir = "";
+string MatrixName = "benchmarks/matrix.xml";
+string OutputName;
+string BaselineName;
+double tolerance = -1.0;
+double warmup = -1.0;
+unsigned int repeat = 0;
+bool SharedEnvironment = false;
+bool SleepWhenSettled = false;
+bool BothPasses = false;
+
+// Allocations are counted per thread so that each worker can measure its own
+// frame loop, leaving out whatever the other threads and the harness allocate.
+static thread_local unsigned long long allocation_count = 0;
+
+struct IntegratorSetting {
+  string name;
+  vector<string> properties;
+  vector<double> values;
+};
+
+struct BenchCase {
+  string script;
+  string aircraft;
+  string initfile;
+  double end_time;
+  double max_allocs;
+};
+
+struct BenchResult {
+  string id;
+  string source;
+  string integrator;
+  unsigned int threads;
+  unsigned long long frames;
+  unsigned long long allocs;
+  double seconds;
+  double frames_per_sec;
+  double allocs_per_frame;
+  long peak_rss_kb;
+  unsigned int asleep;
+  unsigned long long frames_slept;
+  double cpu_saved_sec;
+  map<string, double> model_ns_per_frame;
+};
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+ALLOCATION COUNTING
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+void* operator new(size_t size)
+{
+  allocation_count++;
+  void* p = malloc(size ? size : 1);
+  if (!p) throw bad_alloc();
+  return p;
+}
+
+void* operator new[](size_t size)
+{
+  allocation_count++;
+  void* p = malloc(size ? size : 1);
+  if (!p) throw bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FORWARD DECLARATIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+bool options(int, char**);
+void PrintHelp(void);
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+IMPLEMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+// Lowers the high water mark of the resident set size of the process to its
+// current size, so that the peak read after a case is that of the case alone.
+// Only Linux allows it (through /proc/self/clear_refs); elsewhere the peak is
+// that of the process since it started.
+
+void ResetPeakResident(void)
+{
+#if !defined(_MSC_VER) && !defined(__MINGW32__) && !defined(__APPLE__)
+  ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5";
+#endif
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+// Returns the high water mark of the resident set size of the process.
+
+long PeakResidentKb(void)
+{
+#if defined(_MSC_VER) || defined(__MINGW32__)
+  PROCESS_MEMORY_COUNTERS pmc;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+    return (long)(pmc.PeakWorkingSetSize/1024);
+  return 0;
+#elif defined(__APPLE__)
+  mach_task_basic_info_data_t info;
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS)
+    return 0;
+  return (long)(info.resident_size_max/1024);
+#else
+  ifstream status("/proc/self/status");
+  string line;
+  while (getline(status, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0)
+      return atol(line.c_str() + 6);
+  }
+  return 0;
+#endif
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+bool LoadMatrix(const string& fname, vector<BenchCase>& cases,
+                vector<IntegratorSetting>& integrators, vector<unsigned int>& threads)
+{
+  FGXMLFileRead XMLFileRead;
+  Element* document = XMLFileRead.LoadXMLDocument(RootDir + fname);
+
+  if (!document || document->GetName() != "benchmark") {
+    cerr << "File " << fname << " is not a benchmark matrix" << endl;
+    return false;
+  }
+
+  if (tolerance < 0.0) {
+    if (document->HasAttribute("tolerance"))
+      tolerance = document->GetAttributeValueAsNumber("tolerance");
+    else
+      tolerance = 0.10;
+  }
+
+  if (warmup < 0.0) {
+    if (document->HasAttribute("warmup"))
+      warmup = document->GetAttributeValueAsNumber("warmup");
+    else
+      warmup = 0.0;
+  }
+
+  if (repeat == 0) {
+    if (document->HasAttribute("repeat"))
+      repeat = (unsigned int)document->GetAttributeValueAsNumber("repeat");
+    if (repeat == 0) repeat = 1;
+  }
+
+  Element* el = document->FindElement("script");
+  while (el) {
+    BenchCase c;
+    c.script = el->GetAttributeValue("file");
+    c.end_time = el->HasAttribute("end") ? el->GetAttributeValueAsNumber("end") : 1e99;
+    c.max_allocs = el->HasAttribute("max-allocs") ? el->GetAttributeValueAsNumber("max-allocs") : -1.0;
+    cases.push_back(c);
+    el = document->FindNextElement("script");
+  }
+
+  el = document->FindElement("aircraft");
+  while (el) {
+    BenchCase c;
+    c.aircraft = el->GetAttributeValue("name");
+    c.initfile = el->GetAttributeValue("initfile");
+    c.end_time = el->HasAttribute("end") ? el->GetAttributeValueAsNumber("end") : 10.0;
+    c.max_allocs = el->HasAttribute("max-allocs") ? el->GetAttributeValueAsNumber("max-allocs") : -1.0;
+    cases.push_back(c);
+    el = document->FindNextElement("aircraft");
+  }
+
+  el = document->FindElement("integrator");
+  while (el) {
+    IntegratorSetting s;
+    s.name = el->GetAttributeValue("name");
+    Element* prop = el->FindElement("property");
+    while (prop) {
+      s.properties.push_back(prop->GetDataLine());
+      s.values.push_back(prop->GetAttributeValueAsNumber("value"));
+      prop = el->FindNextElement("property");
+    }
+    integrators.push_back(s);
+    el = document->FindNextElement("integrator");
+  }
+  if (integrators.empty()) {
+    IntegratorSetting s;
+    s.name = "default";
+    integrators.push_back(s);
+  }
+
+  el = document->FindElement("threads");
+  while (el) {
+    threads.push_back((unsigned int)el->GetDataAsNumber());
+    el = document->FindNextElement("threads");
+  }
+  if (threads.empty()) threads.push_back(1);
+
+  return !cases.empty();
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+JSBSim::FGFDMExec* LoadCase(const BenchCase& c, const IntegratorSetting& integrator)
+{
+  JSBSim::FGFDMExec* fdm = new JSBSim::FGFDMExec();
+  if (SharedEnvironment) fdm->SetEnvironment(&JSBSim::FGEnvironment::GetShared());
+  // Headless: the sockets and files the aircraft asks for are not opened,
+  // and would clash between the FDMs of a multi-threaded case anyway.
+  fdm->SetIODirectivesEnabled(false);
+  fdm->SetRootDir(RootDir);
+  fdm->SetAircraftPath("aircraft");
+  fdm->SetEnginePath("engine");
+  fdm->SetSystemsPath("systems");
+
+  bool result;
+  if (!c.script.empty()) {
+    result = fdm->LoadScript(c.script);
+  } else {
+    result = fdm->LoadModel(c.aircraft) && fdm->GetIC()->Load(c.initfile);
+  }
+
+  if (!result) {
+    delete fdm;
+    return 0;
+  }
+
+  fdm->DisableOutput();
+
+  for (unsigned int i=0; i<integrator.properties.size(); i++)
+    fdm->SetPropertyValue(integrator.properties[i], integrator.values[i]);
+
+  if (SleepWhenSettled) fdm->SetSleepEnabled(true);
+
+  fdm->RunIC();
+
+  return fdm;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Messages are drained as JSBSim's own loop does, so that the message ring is
+// reused rather than grown.
+
+bool RunFrame(JSBSim::FGFDMExec* fdm)
+{
+  fdm->ProcessMessage();
+  return fdm->Run();
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// The ground callback is a process wide static that every executive clears
+// when it is destroyed, while the executives destroyed after it still need it
+// to untie their properties. Hold a reference and restore it before each one.
+
+void DeleteFDMs(vector<JSBSim::FGFDMExec*>& fdms)
+{
+  JSBSim::FGGroundCallback_ptr ground = JSBSim::FGLocation::GetGroundCallback();
+
+  for (unsigned int i=0; i<fdms.size(); i++) {
+    JSBSim::FGLocation::SetGroundCallback(ground);
+    delete fdms[i];
+  }
+  fdms.clear();
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// The FDMs are built and destroyed on the calling thread and only their Run()
+// loops execute concurrently: loading a model touches process wide state
+// (the default ground callback, the XML parser) that is not meant to be
+// shared between threads.
+
+bool RunCase(const BenchCase& c, const IntegratorSetting& integrator,
+             unsigned int nthreads, BenchResult& r)
+{
+  JSBSim::FGFDMExec::SleepStatistics before = JSBSim::FGFDMExec::GetSleepStatistics();
+
+  // Give what the previous cases freed back to the system first, so that it
+  // is not counted in the peak of the next one.
+#if defined(__GLIBC__)
+  malloc_trim(0);
+#endif
+  ResetPeakResident();
+
+  vector<JSBSim::FGFDMExec*> fdms;
+  for (unsigned int i=0; i<nthreads; i++) {
+    JSBSim::FGFDMExec* fdm = LoadCase(c, integrator);
+    if (!fdm) break;
+    fdms.push_back(fdm);
+  }
+
+  if (fdms.size() != nthreads) {
+    DeleteFDMs(fdms);
+    return false;
+  }
+
+  vector<unsigned long long> frames(nthreads, 0);
+  vector<unsigned long long> allocs(nthreads, 0);
+
+  // Each worker first runs the warmup on its own thread, so that the
+  // transients of the first frames (lazily built property paths and per
+  // thread caches, trim events, ...) pass before anything is measured. The
+  // clock starts once every worker is warm.
+  mutex lock;
+  condition_variable cv;
+  unsigned int warm = 0;
+  bool go = false;
+
+  vector<thread> workers;
+  for (unsigned int i=0; i<nthreads; i++) {
+    workers.push_back(thread([&, i]() {
+      JSBSim::FGFDMExec* fdm = fdms[i];
+      bool running = true;
+      while (running && fdm->GetSimTime() < warmup) running = RunFrame(fdm);
+      fdm->SetModelTiming(true);
+
+      {
+        unique_lock<mutex> guard(lock);
+        warm++;
+        cv.notify_all();
+        cv.wait(guard, [&]() {return go;});
+      }
+
+      unsigned long long n = 0;
+      unsigned long long allocs_before = allocation_count;
+      while (running && fdm->GetSimTime() <= c.end_time) {
+        running = RunFrame(fdm);
+        n++;
+      }
+      allocs[i] = allocation_count - allocs_before;
+      frames[i] = n;
+    }));
+  }
+
+  chrono::steady_clock::time_point start;
+  {
+    unique_lock<mutex> guard(lock);
+    cv.wait(guard, [&]() {return warm == nthreads;});
+    start = chrono::steady_clock::now();
+    go = true;
+    cv.notify_all();
+  }
+  for (unsigned int i=0; i<workers.size(); i++) workers[i].join();
+
+  chrono::steady_clock::time_point stop = chrono::steady_clock::now();
+
+  r.source = c.script.empty() ? c.aircraft : c.script;
+  r.integrator = integrator.name;
+  r.threads = nthreads;
+  r.frames = r.allocs = 0;
+  for (unsigned int i=0; i<nthreads; i++) {
+    r.frames += frames[i];
+    r.allocs += allocs[i];
+  }
+  r.seconds = chrono::duration<double>(stop - start).count();
+  r.frames_per_sec = r.seconds > 0.0 ? r.frames/r.seconds : 0.0;
+  r.allocs_per_frame = r.frames ? (double)r.allocs/r.frames : 0.0;
+
+  ostringstream id;
+  id << r.source << "/" << r.integrator << "/" << nthreads;
+  if (SharedEnvironment) id << "/shared-env";
+  if (SleepWhenSettled) id << "/sleep";
+  r.id = id.str();
+
+  r.asleep = JSBSim::FGFDMExec::GetSleepStatistics().Asleep - before.Asleep;
+  r.peak_rss_kb = PeakResidentKb();
+
+  // Named in the order of FGFDMExec::eModels.
+  static const char* const models[] = {
+    "propagate", "input", "inertial", "atmosphere", "winds", "systems",
+    "mass-balance", "auxiliary", "propulsion", "aerodynamics",
+    "ground-reactions", "external-reactions", "buoyant-forces", "aircraft",
+    "accelerations", "output" };
+  for (unsigned int m=0; m<sizeof(models)/sizeof(models[0]); m++) {
+    double ns = 0.0;
+    for (unsigned int i=0; i<fdms.size(); i++) ns += fdms[i]->GetModelNsPerFrame(m);
+    r.model_ns_per_frame[models[m]] = ns/fdms.size();
+  }
+
+  DeleteFDMs(fdms);
+
+  // The executives report what they slept as they wake up, which they all
+  // did when they were deleted.
+  JSBSim::FGFDMExec::SleepStatistics after = JSBSim::FGFDMExec::GetSleepStatistics();
+  r.frames_slept = after.FramesSlept - before.FramesSlept;
+  r.cpu_saved_sec = after.CPUSaved - before.CPUSaved;
+  return true;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+string ResultToJSON(const BenchResult& r)
+{
+  ostringstream buf;
+  buf << fixed << setprecision(3);
+  buf << "{\"id\":\"" << r.id << "\""
+      << ",\"source\":\"" << r.source << "\""
+      << ",\"integrator\":\"" << r.integrator << "\""
+      << ",\"threads\":" << r.threads
+      << ",\"frames\":" << r.frames
+      << ",\"allocs\":" << r.allocs
+      << ",\"seconds\":" << r.seconds
+      << ",\"frames_per_sec\":" << r.frames_per_sec
+      << ",\"allocs_per_frame\":" << r.allocs_per_frame
+      << ",\"peak_rss_kb\":" << r.peak_rss_kb
+      << ",\"asleep\":" << r.asleep
+      << ",\"frames_slept\":" << r.frames_slept
+      << ",\"cpu_saved_sec\":" << r.cpu_saved_sec
+      << ",\"model_ns_per_frame\":{";
+  map<string, double>::const_iterator it;
+  for (it = r.model_ns_per_frame.begin(); it != r.model_ns_per_frame.end(); ++it) {
+    if (it != r.model_ns_per_frame.begin()) buf << ",";
+    buf << "\"" << it->first << "\":" << it->second;
+  }
+  buf << "}}";
+  return buf.str();
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Baselines are files written by this program, so rather than carrying a full
+// JSON parser the reader only picks the fields it compares out of each line.
+
+double JSONNumber(const string& line, const string& key)
+{
+  string::size_type n = line.find("\"" + key + "\":");
+  if (n == string::npos) return -1.0;
+  return atof(line.c_str() + n + key.size() + 3);
+}
+
+string JSONString(const string& line, const string& key)
+{
+  string::size_type n = line.find("\"" + key + "\":\"");
+  if (n == string::npos) return "";
+  n += key.size() + 4;
+  return line.substr(n, line.find('"', n) - n);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+bool CompareBaseline(const string& fname, const vector<BenchResult>& results)
+{
+  ifstream in(fname.c_str());
+  if (!in.is_open()) {
+    cerr << "Could not open baseline file " << fname << endl;
+    return false;
+  }
+
+  map<string, string> baseline;
+  string line;
+  while (getline(in, line)) {
+    string id = JSONString(line, "id");
+    if (!id.empty()) baseline[id] = line;
+  }
+
+  bool passed = true;
+  cout << fixed << setprecision(3);
+
+  for (unsigned int i=0; i<results.size(); i++) {
+    const BenchResult& r = results[i];
+    map<string, string>::const_iterator it = baseline.find(r.id);
+    if (it == baseline.end()) {
+      cout << "  " << r.id << ": no baseline" << endl;
+      continue;
+    }
+
+    double allocs = JSONNumber(it->second, "allocs");
+    if (allocs < 0.0) {
+      cout << "  " << r.id << ": no allocation baseline" << endl;
+      continue;
+    }
+
+    // Allocation counts are deterministic, so the total over the case is
+    // compared with no absolute slack: against a baseline of zero, a single
+    // allocation is a regression.
+    bool heavier = r.allocs > allocs*(1.0 + tolerance);
+
+    // Frames/s depend on the machine and its load, and vary by tens of percent
+    // between identical runs: they are reported, never gated on.
+    double fps = JSONNumber(it->second, "frames_per_sec");
+
+    cout << "  " << r.id << ": " << r.allocs << " allocs (baseline "
+         << setprecision(0) << allocs << setprecision(3) << "), "
+         << r.frames_per_sec << " frames/s";
+    if (fps > 0.0)
+      cout << " (" << showpos << setprecision(1)
+           << 100.0*(r.frames_per_sec/fps - 1.0) << "%" << noshowpos
+           << setprecision(3) << " against " << fps << ")";
+    if (heavier) {
+      cout << "  REGRESSION";
+      passed = false;
+    }
+    cout << endl;
+  }
+
+  return passed;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Runs every case of the matrix once, with the current options, and appends
+// the results. Returns false when a case failed its steady state check.
+
+bool RunMatrix(const vector<BenchCase>& cases,
+               const vector<IntegratorSetting>& integrators,
+               const vector<unsigned int>& threads, vector<BenchResult>& results)
+{
+  bool passed = true;
+
+  for (unsigned int c=0; c<cases.size(); c++) {
+    for (unsigned int i=0; i<integrators.size(); i++) {
+      for (unsigned int t=0; t<threads.size(); t++) {
+        // Each case is repeated and the fastest run is kept, which filters
+        // out most of the noise caused by the rest of the machine.
+        BenchResult r;
+        bool ok = true;
+        for (unsigned int n=0; ok && n<repeat; n++) {
+          BenchResult attempt;
+          streambuf* saved = cout.rdbuf(0);
+          ok = RunCase(cases[c], integrators[i], threads[t], attempt);
+          cout.rdbuf(saved);
+          cout.clear();
+          if (ok && (n == 0 || attempt.frames_per_sec > r.frames_per_sec)) r = attempt;
+        }
+
+        if (!ok) {
+          cerr << "Case " << (cases[c].script.empty() ? cases[c].aircraft : cases[c].script)
+               << " could not be loaded" << endl;
+          exit(-1);
+        }
+        cerr << r.id << ": " << fixed << setprecision(1) << r.frames_per_sec
+             << " frames/s, " << setprecision(2) << r.allocs_per_frame
+             << " allocs/frame";
+        if (SleepWhenSettled)
+          cerr << ", " << r.asleep << "/" << threads[t] << " asleep, "
+               << r.frames_slept << " frames slept, " << setprecision(3)
+               << r.cpu_saved_sec << " s CPU saved";
+        cerr << endl;
+
+        // The steady state check: after the warmup, a case flagged with
+        // max-allocs must not allocate more than that over its whole run.
+        if (cases[c].max_allocs >= 0.0 && r.allocs > cases[c].max_allocs) {
+          cerr << r.id << ": " << r.allocs << " allocations in the frame loop"
+               << " (at most " << cases[c].max_allocs << " allowed)" << endl;
+          passed = false;
+        }
+        results.push_back(r);
+      }
+    }
+  }
+
+  return passed;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+int main(int argc, char* argv[])
+{
+  if (!options(argc, argv)) {
+    PrintHelp();
+    exit(-1);
+  }
+
+  vector<BenchCase> cases;
+  vector<IntegratorSetting> integrators;
+  vector<unsigned int> threads;
+
+  if (!LoadMatrix(MatrixName, cases, integrators, threads)) exit(-1);
+
+  // Run headless: no startup banners and nothing printed by the scripts.
+  JSBSim::FGJSBBase::debug_lvl = 0;
+  vector<BenchResult> results;
+  bool passed = true;
+
+  // With --both, a first pass runs the matrix awake and a second one lets
+  // the FDMs sleep; their results have distinct identifiers.
+  vector<bool> passes;
+  if (BothPasses) {
+    passes.push_back(false);
+    passes.push_back(true);
+  } else {
+    passes.push_back(SleepWhenSettled);
+  }
+
+  for (unsigned int p=0; p<passes.size(); p++) {
+    SleepWhenSettled = passes[p];
+    if (!RunMatrix(cases, integrators, threads, results)) passed = false;
+  }
+
+  ostringstream json;
+  json << "{\"matrix\":\"" << MatrixName << "\",\"results\":[" << endl;
+  for (unsigned int i=0; i<results.size(); i++)
+    json << ResultToJSON(results[i]) << (i+1 < results.size() ? "," : "") << endl;
+  json << "]}" << endl;
+
+  if (OutputName.empty()) {
+    cout << json.str();
+  } else {
+    ofstream out(OutputName.c_str());
+    out << json.str();
+  }
+
+  if (!BaselineName.empty()) {
+    cout << "Comparison against " << BaselineName << " (allocation tolerance "
+         << tolerance*100.0 << "%):" << endl;
+    if (!CompareBaseline(BaselineName, results)) passed = false;
+  }
+
+  return passed ? 0 : 1;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+#define gripe cerr << "Option '" << keyword     \
+    << "' requires a value, as in '"    \
+    << keyword << "=something'" << endl << endl;/**/
+
+bool options(int count, char **arg)
+{
+  bool result = true;
+
+  for (int i=1; i<count; i++) {
+    string argument = string(arg[i]);
+    string keyword(argument);
+    string value("");
+    string::size_type n=argument.find("=");
+
+    if (n != string::npos && n > 0) {
+      keyword = argument.substr(0, n);
+      value = argument.substr(n+1);
+    }
+
+    if (keyword == "--help") {
+      PrintHelp();
+      exit(0);
+    } else if (keyword == "--root") {
+      if (n != string::npos) {
+        RootDir = value;
+        if (RootDir[RootDir.length()-1] != '/') RootDir += '/';
+      } else {
+        gripe;
+        exit(1);
+      }
+    } else if (keyword == "--matrix") {
+      if (n != string::npos) {
+        MatrixName = value;
+      } else {
+        gripe;
+        exit(1);
+      }
+    } else if (keyword == "--output") {
+      if (n != string::npos) {
+        OutputName = value;
+      } else {
+        gripe;
+        exit(1);
+      }
+    } else if (keyword == "--baseline") {
+      if (n != string::npos) {
+        BaselineName = value;
+      } else {
+        gripe;
+        exit(1);
+      }
+    } else if (keyword == "--warmup") {
+      if (n != string::npos) {
+        warmup = atof(value.c_str());
+      } else {
+        gripe;
+        exit(1);
+      }
+    } else if (keyword == "--repeat") {
+      if (n != string::npos) {
+        repeat = atoi(value.c_str());
+      } else {
+        gripe;
+        exit(1);
+      }
+    } else if (keyword == "--shared-environment") {
+      SharedEnvironment = true;
+    } else if (keyword == "--sleep") {
+      SleepWhenSettled = true;
+    } else if (keyword == "--both") {
+      BothPasses = true;
+    } else if (keyword == "--tolerance") {
+      if (n != string::npos) {
+        tolerance = atof(value.c_str());
+      } else {
+        gripe;
+        exit(1);
+      }
+    } else {
+      cerr << "The argument \"" << keyword << "\" cannot be interpreted as an option." << endl;
+      result = false;
+    }
+  }
+
+  return result;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void PrintHelp(void)
+{
+  cout << endl << "  Usage: JSBSimBench <options>" << endl << endl;
+  cout << "  options:" << endl;
+  cout << "    --help  returns this message" << endl;
+  cout << "    --root=<path>  specifies the JSBSim root directory (where aircraft/, engine/, etc. reside)" << endl;
+  cout << "    --matrix=<filename>  the benchmark matrix, relative to the root (default benchmarks/matrix.xml)" << endl;
+  cout << "    --output=<filename>  writes the JSON results to a file instead of the console" << endl;
+  cout << "    --baseline=<filename>  compares the results against a previous JSON output" << endl;
+  cout << "    --warmup=<seconds>  overrides the simulated time run before measuring given in the matrix" << endl;
+  cout << "    --repeat=<count>  overrides the number of runs per case given in the matrix; the fastest is kept" << endl;
+  cout << "    --tolerance=<fraction>  overrides the allocation tolerance given in the matrix (e.g. 0.1)" << endl;
+  cout << "    --shared-environment  attaches every FDM to the process-wide FGEnvironment" << endl;
+  cout << "    --sleep  lets every FDM sleep once its vehicle has settled" << endl;
+  cout << "    --both  runs the matrix without, then with --sleep, and reports both" << endl << endl;
+}
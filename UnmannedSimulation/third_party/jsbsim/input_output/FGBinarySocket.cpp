@@ -0,0 +1,478 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+ Module:       FGBinarySocket.cpp
+ Date started: 10/18/26
+ Purpose:      Serves the binary property session protocol
+ Called by:    FGInput
+
+ ------------- Copyright (C) 2026 -------------
+
+ This program is free software; you can redistribute it and/or modify it under
+ the terms of the GNU Lesser General Public License as published by the Free Software
+ Foundation; either version 2 of the License, or (at your option) any later
+ version.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ details.
+
+ You should have received a copy of the GNU Lesser General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ Place - Suite 330, Boston, MA  02111-1307, USA.
+
+ Further information about the GNU Lesser General Public License can also be found on
+ the world wide web at http://www.gnu.org.
+
+FUNCTIONAL DESCRIPTION
+--------------------------------------------------------------------------------
+This class serves property sessions over a TCP or UDP socket: it applies the
+client's registrations, sets and commands, and sends it the changes of the
+properties it subscribed to.
+
+HISTORY
+--------------------------------------------------------------------------------
+10/18/26          Created
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include <cmath>
+#include <cstdlib>
+
+#include "FGBinarySocket.h"
+#include "FGFDMExec.h"
+#include "input_output/FGXMLElement.h"
+#include "input_output/string_utilities.h"
+
+using namespace std;
+
+namespace JSBSim {
+
+IDENT(IdSrc,"$Id: FGBinarySocket.cpp,v 1.1 2026/10/18 00:00:00 Exp $");
+IDENT(IdHdr,ID_BINARYSOCKET);
+
+// Datagrams are kept within an Ethernet frame; TCP messages are only limited
+// by the u16 payload length.
+static const size_t DatagramSize = 1472;
+static const size_t MaxUpdateEntriesUDP =
+  (DatagramSize - FGPropertyProtocol::HeaderSize - FGPropertyProtocol::UpdateHeaderSize)
+  / FGPropertyProtocol::UpdateEntrySize;
+static const size_t MaxUpdateEntriesTCP =
+  (FGPropertyProtocol::MaxPayload - FGPropertyProtocol::UpdateHeaderSize)
+  / FGPropertyProtocol::UpdateEntrySize;
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS IMPLEMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+FGBinarySocket::FGBinarySocket(FGFDMExec* fdmex) :
+  FGInputType(fdmex),
+  SockPort(0),
+  SockProtocol(FGfdmSocket::ptTCP),
+  socket(0),
+  Connection(0),
+  Greeted(false),
+  UpdateCount(0),
+  UpdateStart(0),
+  UpdateMark(0)
+{
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+FGBinarySocket::~FGBinarySocket()
+{
+  delete socket;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+bool FGBinarySocket::Load(Element* el)
+{
+  if (!FGInputType::Load(el))
+    return false;
+
+  SockPort = atoi(el->GetAttributeValue("port").c_str());
+
+  if (SockPort == 0) {
+    cerr << endl << "No port assigned in input element" << endl;
+    return false;
+  }
+
+  string proto = el->GetAttributeValue("protocol");
+  if (to_upper(proto) == "UDP")
+    SockProtocol = FGfdmSocket::ptUDP;
+  else // Default to TCP
+    SockProtocol = FGfdmSocket::ptTCP;
+
+  if (el->HasAttribute("rate")) {
+    double rate = el->GetAttributeValueAsNumber("rate");
+    if (rate > 0.0) SetRate(0.5 + 1.0/(FDMExec->GetDeltaT()*rate));
+  }
+
+  return true;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+bool FGBinarySocket::InitModel(void)
+{
+  if (!FGInputType::InitModel()) return false;
+
+  // Unlike FGInputSocket, the socket is not reopened on reset: a client stays
+  // connected, and registered, across FGFDMExec::RunIC().
+  if (socket == 0) {
+    if (SockProtocol == FGfdmSocket::ptUDP)
+      socket = new FGfdmSocket(SockPort, FGfdmSocket::ptUDP, FGfdmSocket::dIN);
+    else
+      socket = new FGfdmSocket(SockPort);
+  }
+
+  return socket->GetConnectStatus();
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void FGBinarySocket::Read(bool /*Holding*/)
+{
+  if (socket == 0) return;
+  if (!socket->GetConnectStatus()) return;
+
+  // Whatever could not be sent last time goes first; no new updates are
+  // queued behind it, so a slow client gets fewer updates rather than an
+  // ever growing backlog.
+  bool backlogged = !Outbound.empty();
+
+  char chunk[4096];
+  int num_chars;
+
+  while (true) {
+    num_chars = socket->Receive(chunk, sizeof chunk);
+
+    if (socket->GetConnectionCount() != Connection) {
+      Connection = socket->GetConnectionCount();
+      Inbound.clear();
+      ResetSession();
+      backlogged = false;
+    }
+
+    if (num_chars <= 0) break;
+
+    Inbound.insert(Inbound.end(), chunk, chunk + num_chars);
+
+    size_t used = 0;
+    while (size_t length = Protocol::FrameLength(Inbound.data() + used, Inbound.size() - used)) {
+      Protocol::Reader in(Inbound.data() + used + Protocol::HeaderSize,
+                          length - Protocol::HeaderSize);
+      Dispatch(Inbound[used+2], in);
+      used += length;
+    }
+
+    // A datagram only holds whole messages; a stream may end mid-message.
+    if (SockProtocol == FGfdmSocket::ptUDP)
+      Inbound.clear();
+    else
+      Inbound.erase(Inbound.begin(), Inbound.begin() + used);
+  }
+
+  if (Greeted && !backlogged) Publish();
+
+  Flush();
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void FGBinarySocket::ResetSession(void)
+{
+  Registrations.clear();
+  Outbound.clear();
+  Greeted = false;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void FGBinarySocket::Dispatch(uint8_t type, Protocol::Reader& in)
+{
+  Protocol::Writer out(Outbound);
+
+  if (!Greeted && type != Protocol::mtHello) {
+    Protocol::WriteError(out, Protocol::ecBadMessage, type, 0);
+    return;
+  }
+
+  switch (type) {
+  case Protocol::mtHello:
+    {
+      uint32_t magic = in.U32();
+      uint8_t version = in.U8();
+
+      if (!in.Good() || magic != Protocol::Magic || version != Protocol::Version) {
+        Protocol::WriteError(out, Protocol::ecVersion, type, Protocol::Version);
+        return;
+      }
+
+      ResetSession();
+      Greeted = true;
+
+      out.Begin(Protocol::mtHelloReply);
+      out.U32(Protocol::Magic);
+      out.U8(Protocol::Version);
+      out.End();
+    }
+    break;
+
+  case Protocol::mtRegister:
+    Register(in);
+    break;
+
+  case Protocol::mtSet:
+    {
+      uint16_t count = in.U16();
+
+      for (unsigned int i=0; i<count; i++) {
+        uint16_t id = in.U16();
+        double value = in.F64();
+        if (!in.Good()) break;
+
+        if (!ValidID(id))
+          Protocol::WriteError(out, Protocol::ecUnknownID, type, id);
+        else if (!Registrations[id].node->setDoubleValue(value))
+          Protocol::WriteError(out, Protocol::ecNotLeaf, type, id);
+      }
+    }
+    break;
+
+  case Protocol::mtSubscribe:
+  case Protocol::mtUnsubscribe:
+    {
+      double period = 0.0, deadband = 0.0;
+      if (type == Protocol::mtSubscribe) {
+        period = in.F64();
+        deadband = in.F64();
+      }
+      uint16_t count = in.U16();
+
+      for (unsigned int i=0; i<count; i++) {
+        uint16_t id = in.U16();
+        if (!in.Good()) break;
+
+        if (!ValidID(id)) {
+          Protocol::WriteError(out, Protocol::ecUnknownID, type, id);
+          continue;
+        }
+
+        Registration& r = Registrations[id];
+        r.subscribed = type == Protocol::mtSubscribe;
+        r.fresh = r.subscribed;
+        r.period = period;
+        r.deadband = fabs(deadband);
+      }
+    }
+    break;
+
+  case Protocol::mtGet:
+    {
+      double time = FDMExec->GetSimTime();
+      uint16_t count = in.U16();
+
+      for (unsigned int i=0; i<count; i++) {
+        uint16_t id = in.U16();
+        if (!in.Good()) break;
+
+        if (ValidID(id)) {
+          AddUpdate(out, time, id, Registrations[id].node->getDoubleValue());
+        } else {
+          EndUpdate(out);
+          Protocol::WriteError(out, Protocol::ecUnknownID, type, id);
+        }
+      }
+
+      EndUpdate(out);
+    }
+    break;
+
+  case Protocol::mtControl:
+    {
+      uint8_t command = in.U8();
+      uint32_t argument = in.U32();
+      if (!in.Good()) break;
+
+      if (command == Protocol::ccHold) {
+        FDMExec->Hold();
+      } else if (command == Protocol::ccResume) {
+        FDMExec->Resume();
+      } else if (command == Protocol::ccIterate && argument > 0) {
+        FDMExec->EnableIncrementThenHold(argument);
+        FDMExec->Resume();
+      } else {
+        Protocol::WriteError(out, Protocol::ecBadMessage, type, command);
+      }
+    }
+    break;
+
+  case Protocol::mtBye:
+    ResetSession();
+    return;
+
+  default:
+    Protocol::WriteError(out, Protocol::ecBadMessage, type, 0);
+    return;
+  }
+
+  if (!in.Good())
+    Protocol::WriteError(out, Protocol::ecBadMessage, type, 0);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void FGBinarySocket::Register(Protocol::Reader& in)
+{
+  Protocol::Writer out(Outbound);
+  uint16_t count = in.U16();
+  uint16_t registered = 0;
+
+  out.Begin(Protocol::mtRegistered);
+  size_t mark = out.Mark();
+
+  for (unsigned int i=0; i<count; i++) {
+    in.String(Path);
+    if (!in.Good()) break;
+
+    FGPropertyNode* node = 0;
+    try {
+      node = PropertyManager->GetNode(Path);
+    } catch(...) {
+      node = 0;
+    }
+
+    uint16_t id = Protocol::InvalidID;
+
+    if (node && node->hasValue()) {
+      for (size_t j=0; j<Registrations.size(); j++) {
+        if (Registrations[j].node == node) {
+          id = static_cast<uint16_t>(j);
+          break;
+        }
+      }
+
+      if (id == Protocol::InvalidID && Registrations.size() < Protocol::InvalidID) {
+        Registration r = { node, false, false, 0.0, 0.0, 0.0, 0.0 };
+        id = static_cast<uint16_t>(Registrations.size());
+        Registrations.push_back(r);
+      }
+    }
+
+    out.U16(id);
+    registered++;
+  }
+
+  out.Patch(mark, registered);
+  out.End();
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void FGBinarySocket::Publish(void)
+{
+  Protocol::Writer out(Outbound);
+  double time = FDMExec->GetSimTime();
+  // Sim time advances by a sum of time steps: allow for its round off.
+  double slack = 0.5*FDMExec->GetDeltaT();
+
+  for (size_t id=0; id<Registrations.size(); id++) {
+    Registration& r = Registrations[id];
+    if (!r.subscribed) continue;
+
+    double value = r.node->getDoubleValue();
+
+    if (!r.fresh) {
+      bool moved = std::isnan(value) != std::isnan(r.published)
+                || fabs(value - r.published) > r.deadband;
+      if (!moved) continue;
+
+      // Not due yet: the change stays pending until it is. A time that went
+      // back is a reset, after which everything is due.
+      if (time >= r.publishedAt && time - r.publishedAt < r.period - slack) continue;
+    }
+
+    AddUpdate(out, time, static_cast<uint16_t>(id), value);
+    r.fresh = false;
+    r.published = value;
+    r.publishedAt = time;
+  }
+
+  EndUpdate(out);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void FGBinarySocket::AddUpdate(Protocol::Writer& out, double time, uint16_t id, double value)
+{
+  if (UpdateCount == 0) {
+    UpdateStart = out.Begin(Protocol::mtUpdate);
+    out.F64(time);
+    UpdateMark = out.Mark();
+  }
+
+  out.U16(id);
+  out.F64(value);
+  UpdateCount++;
+
+  size_t limit = SockProtocol == FGfdmSocket::ptUDP ? MaxUpdateEntriesUDP : MaxUpdateEntriesTCP;
+  if (UpdateCount == limit) EndUpdate(out);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void FGBinarySocket::EndUpdate(Protocol::Writer& out)
+{
+  if (UpdateCount == 0) return;
+
+  out.Patch(UpdateMark, static_cast<uint16_t>(UpdateCount));
+  out.End(UpdateStart);
+  UpdateCount = 0;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void FGBinarySocket::Flush(void)
+{
+  size_t sent = 0;
+
+  while (sent < Outbound.size()) {
+    size_t length = Outbound.size() - sent;
+
+    if (SockProtocol == FGfdmSocket::ptUDP) {
+      // As many whole messages as fit in a datagram, or one larger message
+      // on its own.
+      length = 0;
+      while (size_t next = Protocol::FrameLength(Outbound.data() + sent + length,
+                                                 Outbound.size() - sent - length)) {
+        if (length > 0 && length + next > DatagramSize) break;
+        length += next;
+      }
+    }
+
+    int num_chars = socket->Reply(reinterpret_cast<const char*>(Outbound.data()) + sent,
+                                  static_cast<int>(length));
+
+    if (num_chars < 0) {
+      // The TCP client has gone. A UDP send that failed only loses its
+      // datagram.
+      if (SockProtocol == FGfdmSocket::ptTCP) {
+        ResetSession();
+        return;
+      }
+      num_chars = static_cast<int>(length);
+    }
+
+    sent += num_chars;
+    if (static_cast<size_t>(num_chars) < length) break; // socket buffer full
+  }
+
+  Outbound.erase(Outbound.begin(), Outbound.begin() + sent);
+}
+
+}
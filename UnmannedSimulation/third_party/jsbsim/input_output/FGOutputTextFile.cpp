@@ -289,9 +289,9 @@ void FGOutputTextFile::Print(void)
   }
   if (SubSystems & ssRates) {
     outstream << delimeter;
-    outstream << (radtodeg*Propagate->GetPQR()).Dump(delimeter) << delimeter;
-    outstream << (radtodeg*Accelerations->GetPQRdot()).Dump(delimeter) << delimeter;
-    outstream << (radtodeg*Propagate->GetPQRi()).Dump(delimeter);
+    (radtodeg*Propagate->GetPQR()).Dump(outstream, delimeter); outstream << delimeter;
+    (radtodeg*Accelerations->GetPQRdot()).Dump(outstream, delimeter); outstream << delimeter;
+    (radtodeg*Propagate->GetPQRi()).Dump(outstream, delimeter);
   }
   if (SubSystems & ssVelocities) {
     outstream << delimeter;
@@ -299,36 +299,36 @@ void FGOutputTextFile::Print(void)
     outstream << Auxiliary->GetReynoldsNumber() << delimeter;
     outstream << setprecision(12) << Auxiliary->GetVt() << delimeter;
     outstream << Propagate->GetInertialVelocityMagnitude() << delimeter;
-    outstream << setprecision(12) << Propagate->GetUVW().Dump(delimeter) << delimeter;
-    outstream << setprecision(12) << Accelerations->GetUVWdot().Dump(delimeter) << delimeter;
-    outstream << setprecision(12) << Accelerations->GetUVWidot().Dump(delimeter) << delimeter;
-    outstream << setprecision(12) << Accelerations->GetBodyAccel().Dump(delimeter) << delimeter;
-    outstream << Auxiliary->GetAeroUVW().Dump(delimeter) << delimeter;
-    outstream << Propagate->GetInertialVelocity().Dump(delimeter) << delimeter;
-    outstream << Propagate->GetECEFVelocity().Dump(delimeter) << delimeter;
-    outstream << Propagate->GetVel().Dump(delimeter);
+    Propagate->GetUVW().Dump(outstream, delimeter); outstream << delimeter;
+    Accelerations->GetUVWdot().Dump(outstream, delimeter); outstream << delimeter;
+    Accelerations->GetUVWidot().Dump(outstream, delimeter); outstream << delimeter;
+    Accelerations->GetBodyAccel().Dump(outstream, delimeter); outstream << delimeter;
+    Auxiliary->GetAeroUVW().Dump(outstream, delimeter); outstream << delimeter;
+    Propagate->GetInertialVelocity().Dump(outstream, delimeter); outstream << delimeter;
+    Propagate->GetECEFVelocity().Dump(outstream, delimeter); outstream << delimeter;
+    Propagate->GetVel().Dump(outstream, delimeter);
     outstream.precision(10);
   }
   if (SubSystems & ssForces) {
     outstream << delimeter;
-    outstream << Aerodynamics->GetvFw().Dump(delimeter) << delimeter;
+    Aerodynamics->GetvFw().Dump(outstream, delimeter); outstream << delimeter;
     outstream << Aerodynamics->GetLoD() << delimeter;
-    outstream << Aerodynamics->GetForces().Dump(delimeter) << delimeter;
-    outstream << Propulsion->GetForces().Dump(delimeter) << delimeter;
-    outstream << GroundReactions->GetForces().Dump(delimeter) << delimeter;
-    outstream << ExternalReactions->GetForces().Dump(delimeter) << delimeter;
-    outstream << BuoyantForces->GetForces().Dump(delimeter) << delimeter;
-    outstream << Aircraft->GetForces().Dump(delimeter);
+    Aerodynamics->GetForces().Dump(outstream, delimeter); outstream << delimeter;
+    Propulsion->GetForces().Dump(outstream, delimeter); outstream << delimeter;
+    GroundReactions->GetForces().Dump(outstream, delimeter); outstream << delimeter;
+    ExternalReactions->GetForces().Dump(outstream, delimeter); outstream << delimeter;
+    BuoyantForces->GetForces().Dump(outstream, delimeter); outstream << delimeter;
+    Aircraft->GetForces().Dump(outstream, delimeter);
   }
   if (SubSystems & ssMoments) {
     outstream << delimeter;
-    outstream << Aerodynamics->GetMoments().Dump(delimeter) << delimeter;
-    outstream << Aerodynamics->GetMomentsMRC().Dump(delimeter) << delimeter;
-    outstream << Propulsion->GetMoments().Dump(delimeter) << delimeter;
-    outstream << GroundReactions->GetMoments().Dump(delimeter) << delimeter;
-    outstream << ExternalReactions->GetMoments().Dump(delimeter) << delimeter;
-    outstream << BuoyantForces->GetMoments().Dump(delimeter) << delimeter;
-    outstream << Aircraft->GetMoments().Dump(delimeter);
+    Aerodynamics->GetMoments().Dump(outstream, delimeter); outstream << delimeter;
+    Aerodynamics->GetMomentsMRC().Dump(outstream, delimeter); outstream << delimeter;
+    Propulsion->GetMoments().Dump(outstream, delimeter); outstream << delimeter;
+    GroundReactions->GetMoments().Dump(outstream, delimeter); outstream << delimeter;
+    ExternalReactions->GetMoments().Dump(outstream, delimeter); outstream << delimeter;
+    BuoyantForces->GetMoments().Dump(outstream, delimeter); outstream << delimeter;
+    Aircraft->GetMoments().Dump(outstream, delimeter);
   }
   if (SubSystems & ssAtmosphere) {
     outstream << delimeter;
@@ -340,34 +340,34 @@ void FGOutputTextFile::Print(void)
     outstream << Atmosphere->GetPressure() << delimeter;
     outstream << Winds->GetTurbMagnitude() << delimeter;
     outstream << Winds->GetTurbDirection() << delimeter;
-    outstream << Winds->GetTotalWindNED().Dump(delimeter) << delimeter;
-    outstream << (Winds->GetTurbPQR()*radtodeg).Dump(delimeter);
+    Winds->GetTotalWindNED().Dump(outstream, delimeter); outstream << delimeter;
+    (Winds->GetTurbPQR()*radtodeg).Dump(outstream, delimeter);
   }
   if (SubSystems & ssMassProps) {
     outstream << delimeter;
-    outstream << MassBalance->GetJ().Dump(delimeter) << delimeter;
+    MassBalance->GetJ().Dump(outstream, delimeter); outstream << delimeter;
     outstream << MassBalance->GetMass() << delimeter;
     outstream << MassBalance->GetWeight() << delimeter;
-    outstream << MassBalance->GetXYZcg().Dump(delimeter);
+    MassBalance->GetXYZcg().Dump(outstream, delimeter);
   }
   if (SubSystems & ssPropagate) {
     outstream.precision(14);
     outstream << delimeter;
     outstream << Propagate->GetAltitudeASL() << delimeter;
     outstream << Propagate->GetDistanceAGL() << delimeter;
-    outstream << (radtodeg*Propagate->GetEuler()).Dump(delimeter) << delimeter;
-    outstream << Propagate->GetQuaternion().Dump(delimeter) << delimeter;
+    (radtodeg*Propagate->GetEuler()).Dump(outstream, delimeter); outstream << delimeter;
+    Propagate->GetQuaternion().Dump(outstream, delimeter); outstream << delimeter;
     FGQuaternion Qec = Propagate->GetQuaternionECEF();
-    outstream << Qec.Dump(delimeter) << delimeter;
-    outstream << Propagate->GetQuaternionECI().Dump(delimeter) << delimeter;
+    Qec.Dump(outstream, delimeter); outstream << delimeter;
+    Propagate->GetQuaternionECI().Dump(outstream, delimeter); outstream << delimeter;
     outstream << Auxiliary->Getalpha(inDegrees) << delimeter;
     outstream << Auxiliary->Getbeta(inDegrees) << delimeter;
     outstream << Propagate->GetLocation().GetLatitudeDeg() << delimeter;
     outstream << Propagate->GetLocation().GetGeodLatitudeDeg() << delimeter;
     outstream << Propagate->GetLocation().GetLongitudeDeg() << delimeter;
     outstream.precision(18);
-    outstream << ((FGColumnVector3)Propagate->GetInertialPosition()).Dump(delimeter) << delimeter;
-    outstream << ((FGColumnVector3)Propagate->GetLocation()).Dump(delimeter) << delimeter;
+    ((FGColumnVector3)Propagate->GetInertialPosition()).Dump(outstream, delimeter); outstream << delimeter;
+    ((FGColumnVector3)Propagate->GetLocation()).Dump(outstream, delimeter); outstream << delimeter;
     outstream.precision(14);
     outstream << Propagate->GetEarthPositionAngleDeg() << delimeter;
     outstream << Propagate->GetDistanceAGL() << delimeter;
@@ -0,0 +1,251 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+ Header:       FGPropertyProtocol.h
+ Date started: 10/18/26
+ Purpose:      Wire format of the binary property session protocol
+
+ ------------- Copyright (C) 2026 -------------
+
+ This program is free software; you can redistribute it and/or modify it under
+ the terms of the GNU Lesser General Public License as published by the Free Software
+ Foundation; either version 2 of the License, or (at your option) any later
+ version.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ details.
+
+ You should have received a copy of the GNU Lesser General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ Place - Suite 330, Boston, MA  02111-1307, USA.
+
+ Further information about the GNU Lesser General Public License can also be found on
+ the world wide web at http://www.gnu.org.
+
+HISTORY
+--------------------------------------------------------------------------------
+10/18/26          Created
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+SENTRY
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef FGPROPERTYPROTOCOL_H
+#define FGPROPERTYPROTOCOL_H
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#define ID_PROPERTYPROTOCOL "$Id: FGPropertyProtocol.h,v 1.1 2026/10/18 00:00:00 Exp $"
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FORWARD DECLARATIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace JSBSim {
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DOCUMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/** Wire format of the binary property session protocol.
+    A client opens a session, registers the property paths it is interested
+    in once and from then on refers to them by the 16 bit IDs it got back:
+    it sets them in batches and subscribes to them, after which the server
+    sends it the values that changed, no more often than the period the
+    client asked for. No property path is looked up and no number is
+    formatted or parsed as text once the properties are registered.
+
+    The protocol is spoken by FGBinarySocket and by the simulation server,
+    which addresses its entities as "<entity>/<property>". This header has no
+    dependency on the rest of JSBSim so that clients can include it as is.
+
+    <h3>Framing</h3>
+
+    Every message is a 3 byte header followed by its payload:
+<pre>
+    u16 payload length
+    u8  message type
+    ... payload
+</pre>
+    All integers are little endian, reals are IEEE 754 doubles stored little
+    endian, and strings are a u16 length followed by that many bytes. Over
+    TCP, messages follow each other in the stream; over UDP, a datagram holds
+    one or more whole messages.
+
+    <h3>Messages</h3>
+<pre>
+    Client to server:
+      HELLO        u32 magic, u8 version. Opens the session and must come
+                   first; the server answers with HELLO_REPLY.
+      REGISTER     u16 count, count x string path. Answered by REGISTERED
+                   with the ID of each path, in order, or InvalidID for the
+                   paths that do not name a property with a value.
+                   Registering a path twice returns the same ID.
+      SET          u16 count, count x (u16 id, f64 value). A value that
+                   cannot be written, such as that of a read-only tied
+                   property, is answered with an ecNotLeaf ERROR.
+      SUBSCRIBE    f64 period (seconds), f64 deadband, u16 count, count x
+                   u16 id. The first update of a newly subscribed property
+                   is sent unconditionally; later ones when its value moved
+                   by more than the deadband, at most once per period.
+      UNSUBSCRIBE  u16 count, count x u16 id.
+      GET          u16 count, count x u16 id. Answered by a single UPDATE
+                   with the current values, whether they changed or not.
+      CONTROL      u8 command, u32 argument (see ControlCommand).
+      BYE          Closes the session: registrations and subscriptions are
+                   dropped.
+
+    Server to client:
+      HELLO_REPLY  u32 magic, u8 version.
+      REGISTERED   u16 count, count x u16 id.
+      UPDATE       f64 time, u16 count, count x (u16 id, f64 value). Large
+                   updates are split over several messages with the same
+                   time.
+      ERROR        u8 code, u8 type of the offending message, u16 detail
+                   (the offending ID where there is one).
+</pre>
+    Sessions belong to the connection: a new TCP connection, or datagrams
+    from a new UDP peer, start a new session.
+  */
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DECLARATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+class FGPropertyProtocol
+{
+public:
+  enum { Magic = 0x5042534A,   // "JSBP"
+         Version = 1,
+         InvalidID = 0xFFFF,
+         HeaderSize = 3,
+         MaxPayload = 0xFFFF };
+
+  enum MessageType { mtHello = 0x00, mtRegister, mtSet, mtSubscribe,
+                     mtUnsubscribe, mtGet, mtControl, mtBye,
+                     mtHelloReply = 0x80, mtRegistered, mtUpdate,
+                     mtError = 0x8F };
+
+  /// Commands of a CONTROL message. Iterate runs the argument's number of frames, then holds.
+  enum ControlCommand { ccHold = 1, ccResume, ccIterate };
+
+  enum ErrorCode { ecBadMessage = 1, ecUnknownID, ecNotLeaf, ecVersion };
+
+  /// Size of the UPDATE payload ahead of its entries, and of each entry.
+  enum { UpdateHeaderSize = 10, UpdateEntrySize = 10 };
+
+  /** Returns the size of the message at the start of data, header included,
+      or 0 if the message is not complete yet. */
+  static size_t FrameLength(const uint8_t* data, size_t size) {
+    if (size < HeaderSize) return 0;
+    size_t length = HeaderSize + (data[0] | (data[1] << 8));
+    return length <= size ? length : 0;
+  }
+
+  /** Appends messages to a buffer. A message is started with Begin() and
+      finished with End(), which fills in its length; messages do not nest. The buffer is only
+      appended to, so a writer over a buffer that has reached its working
+      size does not allocate. */
+  class Writer {
+  public:
+    explicit Writer(std::vector<uint8_t>& buf) : buffer(buf), start(0) {}
+
+    /// Starts a message. Returns where it starts, for End(size_t).
+    size_t Begin(uint8_t type) { start = buffer.size(); U16(0); U8(type); return start; }
+    void End(void) { End(start); }
+    /// Ends the message starting at `at`, which another writer may have begun.
+    void End(size_t at) { Patch(at, static_cast<uint16_t>(buffer.size() - at - HeaderSize)); }
+
+    void U8(uint8_t v) { buffer.push_back(v); }
+    void U16(uint16_t v) { U8(v & 0xFF); U8(v >> 8); }
+    void U32(uint32_t v) { U16(v & 0xFFFF); U16(v >> 16); }
+    void F64(double v) {
+      uint64_t bits;
+      memcpy(&bits, &v, sizeof bits);
+      U32(static_cast<uint32_t>(bits)); U32(static_cast<uint32_t>(bits >> 32));
+    }
+    void String(const std::string& s) {
+      U16(static_cast<uint16_t>(s.size()));
+      buffer.insert(buffer.end(), s.begin(), s.end());
+    }
+
+    /// Reserves a u16, typically a count not known yet, to be set with Patch().
+    size_t Mark(void) { size_t at = buffer.size(); U16(0); return at; }
+    void Patch(size_t at, uint16_t v) {
+      buffer[at] = v & 0xFF;
+      buffer[at+1] = v >> 8;
+    }
+
+    size_t PayloadSize(void) const { return buffer.size() - start - HeaderSize; }
+
+  private:
+    std::vector<uint8_t>& buffer;
+    size_t start;
+  };
+
+  /** Reads the fields of a message payload. Reading past the end of the
+      payload returns zeros and makes Good() false from then on. */
+  class Reader {
+  public:
+    Reader(const uint8_t* data, size_t size) : pos(data), end(data+size), good(true) {}
+
+    uint8_t U8(void) { return Take(1) ? pos[-1] : 0; }
+    uint16_t U16(void) {
+      if (!Take(2)) return 0;
+      return static_cast<uint16_t>(pos[-2] | (pos[-1] << 8));
+    }
+    uint32_t U32(void) { uint32_t lo = U16(); return lo | (static_cast<uint32_t>(U16()) << 16); }
+    double F64(void) {
+      uint64_t bits = U32();
+      bits |= static_cast<uint64_t>(U32()) << 32;
+      double v;
+      memcpy(&v, &bits, sizeof v);
+      return v;
+    }
+    /// Reads a string into s, reusing its storage.
+    void String(std::string& s) {
+      size_t length = U16();
+      if (Take(length)) s.assign(reinterpret_cast<const char*>(pos - length), length);
+      else s.clear();
+    }
+
+    bool Good(void) const { return good; }
+    size_t Remaining(void) const { return end - pos; }
+
+  private:
+    bool Take(size_t n) {
+      if (!good || static_cast<size_t>(end - pos) < n) { good = false; return false; }
+      pos += n;
+      return true;
+    }
+
+    const uint8_t* pos;
+    const uint8_t* end;
+    bool good;
+  };
+
+  /// Appends an ERROR message.
+  static void WriteError(Writer& out, ErrorCode code, uint8_t type, uint16_t detail) {
+    out.Begin(mtError);
+    out.U8(code);
+    out.U8(type);
+    out.U16(detail);
+    out.End();
+  }
+};
+}
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+#endif
@@ -195,7 +195,7 @@ bool FGScript::LoadScript(const string& script, double default_dT,
   }
 
   // Now, read input spec if given.
-  element = document->FindElement("input");
+  element = FDMExec->GetIODirectivesEnabled() ? document->FindElement("input") : 0L;
   while (element) {
     if (!FDMExec->GetInput()->Load(element))
       return false;
@@ -204,7 +204,7 @@ bool FGScript::LoadScript(const string& script, double default_dT,
   }
 
   // Now, read output spec if given.
-  element = document->FindElement("output");
+  element = FDMExec->GetIODirectivesEnabled() ? document->FindElement("output") : 0L;
   while (element) {
     if (!FDMExec->GetOutput()->Load(element))
       return false;
@@ -362,6 +362,18 @@ void FGScript::ResetEvents(void)
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 
+bool FGScript::HasPendingEvents(void) const
+{
+  for (unsigned int i=0; i<Events.size(); i++) {
+    for (unsigned int j=0; j<Events[i].Transiting.size(); j++)
+      if (Events[i].Transiting[j]) return true;
+  }
+
+  return false;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
 bool FGScript::RunScript(void)
 {
   unsigned i, j;
@@ -81,6 +81,7 @@ static bool LoadWinSockDLL(void)
 FGfdmSocket::FGfdmSocket(const string& address, int port, int protocol)
 {
   sckt = sckt_in = 0;
+  Connections = 0;
   Protocol = (ProtocolType)protocol;
   connected = false;
 
@@ -134,7 +135,8 @@ FGfdmSocket::FGfdmSocket(const string& address, int port, int protocol)
 // assumes UDP socket on localhost, for inbound datagrams
 FGfdmSocket::FGfdmSocket(int port, int protocol, int direction) // assumes UDP
 {
-  sckt = -1;
+  sckt = sckt_in = -1;
+  Connections = 0;
   connected = false;
   Protocol = (ProtocolType)protocol;
   Direction = (DirectionType) direction;
@@ -179,6 +181,7 @@ FGfdmSocket::FGfdmSocket(int port, int protocol, int direction) // assumes UDP
 FGfdmSocket::FGfdmSocket(const string& address, int port) // assumes TCP
 {
   sckt = sckt_in = 0;
+  Connections = 0;
   connected = false;
   Protocol = ptTCP;
 
@@ -227,6 +230,7 @@ FGfdmSocket::FGfdmSocket(const string& address, int port) // assumes TCP
 
 FGfdmSocket::FGfdmSocket(int port) // assumes TCP
 {
+  Connections = 0;
   connected = false;
   unsigned long NoBlock = true;
   Protocol = ptTCP;
@@ -350,6 +354,104 @@ int FGfdmSocket::Reply(const string& text)
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 
+int FGfdmSocket::Receive(char* data, int size)
+{
+  int num_chars = 0;
+
+  if (Protocol == ptTCP) {
+    if (sckt_in <= 0) {
+      int len = sizeof(struct sockaddr_in);
+      unsigned long NoBlock = true;
+      #if defined(_MSC_VER) || defined(__MINGW32__)
+        sckt_in = accept(sckt, (struct sockaddr*)&peerName, &len);
+      #else
+        sckt_in = accept(sckt, (struct sockaddr*)&peerName, (socklen_t*)&len);
+      #endif
+      if (sckt_in <= 0) return 0;
+
+      #if defined(_MSC_VER) || defined(__MINGW32__)
+         ioctlsocket(sckt_in, FIONBIO, &NoBlock);
+      #else
+         ioctl(sckt_in, FIONBIO, &NoBlock);
+      #endif
+      Connections++;
+    }
+
+    num_chars = recv(sckt_in, data, size, 0);
+
+    if (num_chars > 0) return num_chars;
+
+    // An orderly shutdown reads as 0 bytes; anything but "would block" is
+    // just as final.
+    #if defined(_MSC_VER) || defined(__MINGW32__)
+    bool pending = num_chars < 0 && WSAGetLastError() == WSAEWOULDBLOCK;
+    #else
+    bool pending = num_chars < 0 && (errno == EWOULDBLOCK || errno == EAGAIN);
+    #endif
+    if (!pending) CloseClient();
+
+    return 0;
+  }
+
+  if (sckt < 0) return 0;
+
+  struct sockaddr_in from;
+  socklen_t fromlen = sizeof from;
+  num_chars = recvfrom(sckt, data, size, 0, (struct sockaddr*)&from, &fromlen);
+  if (num_chars <= 0) return 0;
+
+  if (Connections == 0 || from.sin_port != peerName.sin_port
+      || from.sin_addr.s_addr != peerName.sin_addr.s_addr) {
+    peerName = from;
+    Connections++;
+  }
+
+  return num_chars;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+int FGfdmSocket::Reply(const char* data, int length)
+{
+  // A client that went away must not raise SIGPIPE.
+  #ifdef MSG_NOSIGNAL
+  const int flags = MSG_NOSIGNAL;
+  #else
+  const int flags = 0;
+  #endif
+  int num_chars_sent = -1;
+
+  if (Protocol == ptTCP) {
+    if (sckt_in <= 0) return -1;
+    num_chars_sent = send(sckt_in, data, length, flags);
+    #if defined(_MSC_VER) || defined(__MINGW32__)
+    if (num_chars_sent < 0 && WSAGetLastError() == WSAEWOULDBLOCK) return 0;
+    #else
+    if (num_chars_sent < 0 && (errno == EWOULDBLOCK || errno == EAGAIN)) return 0;
+    #endif
+    if (num_chars_sent < 0) CloseClient();
+  } else if (Connections > 0) {
+    num_chars_sent = sendto(sckt, data, length, flags, (struct sockaddr*)&peerName,
+                            sizeof peerName);
+  }
+
+  return num_chars_sent;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void FGfdmSocket::CloseClient(void)
+{
+  #if defined(_MSC_VER) || defined(__MINGW32__)
+  closesocket(sckt_in);
+  #else
+  close(sckt_in);
+  #endif
+  sckt_in = -1;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
 void FGfdmSocket::Close(void)
 {
   close(sckt_in);
@@ -99,6 +99,19 @@ public:
 
   std::string Receive(void);
   int Reply(const std::string& text);
+
+  /** Reads whatever binary data is waiting, without blocking and without the
+      prompts of the text protocol. A listening TCP socket accepts a pending
+      client first; a UDP socket remembers the sender as the peer to reply to.
+      @return the number of bytes read into data, 0 if there were none. */
+  int Receive(char* data, int size);
+  /** Sends binary data to the connected TCP client or to the last UDP peer.
+      @return the number of bytes sent, which may be less than length when
+              the socket buffer is full, or -1 on error. */
+  int Reply(const char* data, int length);
+  /** Counts the TCP clients accepted and the UDP peers heard from by
+      Receive(char*, int), so that a caller can tell a new session apart. */
+  unsigned int GetConnectionCount(void) const {return Connections;}
   void Append(const std::string& s) {Append(s.c_str());}
   void Append(const char*);
   void Append(double);
@@ -118,9 +131,12 @@ private:
   DirectionType Direction;
   ProtocolType Protocol;
   struct sockaddr_in scktName;
+  struct sockaddr_in peerName;
+  unsigned int Connections;
   struct hostent *host;
   std::ostringstream buffer;
   bool connected;
+  void CloseClient(void);
   void Debug(int from);
 };
 }
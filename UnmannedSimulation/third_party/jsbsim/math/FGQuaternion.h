@@ -487,6 +487,11 @@ public:
 
   std::string Dump(const std::string& delimiter) const;
 
+  /** Writes the contents of the quaternion to a stream.
+      Same format as Dump(delimiter) without building an intermediate string.
+      The precision of the stream is restored afterwards. */
+  void Dump(std::ostream& os, const std::string& delimiter) const;
+
   friend FGQuaternion QExp(const FGColumnVector3& omega);
 
 private:
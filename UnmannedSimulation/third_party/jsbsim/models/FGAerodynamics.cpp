@@ -146,6 +146,9 @@ bool FGAerodynamics::Run(bool Holding)
 
   unsigned int axis_ctr, ctr;
   const double twovel=2*in.Vt;
+#ifdef JSBSIM_PROFILING
+  FGProfiler* profiler = FDMExec->GetProfiler();
+#endif
 
   RunPreFunctions();
 
@@ -181,12 +184,14 @@ bool FGAerodynamics::Run(bool Holding)
 
   for (axis_ctr = 0; axis_ctr < 3; axis_ctr++) {
     for (ctr=0; ctr < AeroFunctions[axis_ctr].size(); ctr++) {
+      FG_PROFILE_SCOPE(profiler, ProfileSlots[axis_ctr][ctr]);
       vFnative(axis_ctr+1) += AeroFunctions[axis_ctr][ctr]->GetValue();
     }
   }
 
   for (axis_ctr = 0; axis_ctr < 3; axis_ctr++) {
     for (ctr=0; ctr < AeroFunctionsAtCG[axis_ctr].size(); ctr++) {
+      FG_PROFILE_SCOPE(profiler, ProfileSlotsAtCG[axis_ctr][ctr]);
       vFnativeAtCG(axis_ctr+1) += AeroFunctionsAtCG[axis_ctr][ctr]->GetValue();
     }
   }
@@ -265,6 +270,7 @@ bool FGAerodynamics::Run(bool Holding)
 
   for (axis_ctr = 0; axis_ctr < 3; axis_ctr++) {
     for (ctr = 0; ctr < AeroFunctions[axis_ctr+3].size(); ctr++) {
+      FG_PROFILE_SCOPE(profiler, ProfileSlots[axis_ctr+3][ctr]);
       vMomentsMRC(axis_ctr+1) += AeroFunctions[axis_ctr+3][ctr]->GetValue();
     }
   }
@@ -354,6 +360,21 @@ bool FGAerodynamics::Load(Element *document)
     axis_element = document->FindNextElement("axis");
   }
 
+#ifdef JSBSIM_PROFILING
+  // Each top-level aerodynamic function gets its own profiler slot.
+  FGProfiler* profiler = FDMExec->GetProfiler();
+  for (unsigned int i=0; i<6; i++) {
+    ProfileSlots[i].clear();
+    for (unsigned int j=0; j<AeroFunctions[i].size(); j++)
+      ProfileSlots[i].push_back(profiler->RegisterSlot(FGProfiler::eFunctions,
+                                                      AeroFunctions[i][j]->GetName()));
+    ProfileSlotsAtCG[i].clear();
+    for (unsigned int j=0; j<AeroFunctionsAtCG[i].size(); j++)
+      ProfileSlotsAtCG[i].push_back(profiler->RegisterSlot(FGProfiler::eFunctions,
+                                                          AeroFunctionsAtCG[i][j]->GetName()));
+  }
+#endif
+
   PostLoad(document, PropertyManager); // Perform base class Post-Load
 
   return true;
@@ -178,8 +178,13 @@ bool FGFCS::Run(bool Holding)
     SteerPosDeg[i] = gear->GetDefaultSteerAngle( GetDsCmd() );
   }
 
+#ifdef JSBSIM_PROFILING
+  FGProfiler* profiler = FDMExec->GetProfiler();
+#endif
+
   // Execute system channels in order
   for (i=0; i<SystemChannels.size(); i++) {
+    FG_PROFILE_SCOPE(profiler, ChannelSlots[i]);
     if (debug_lvl & 4) cout << "    Executing System Channel: " << SystemChannels[i]->GetName() << endl;
     SystemChannels[i]->Execute();
   }
@@ -528,6 +533,13 @@ bool FGFCS::Load(Element* document)
 
     SystemChannels.push_back(newChannel);
 
+#ifdef JSBSIM_PROFILING
+    // Every <system>, <autopilot> and <flight_control> element adds channels,
+    // each timed in its own slot registered here rather than from Run().
+    ChannelSlots.push_back(FDMExec->GetProfiler()->RegisterSlot(FGProfiler::eChannels,
+                                                                newChannel->GetName()));
+#endif
+
     if (debug_lvl > 0)
       cout << endl << highint << fgblue << "    Channel " 
          << normint << channel_element->GetAttributeValue("name") << reset << endl;
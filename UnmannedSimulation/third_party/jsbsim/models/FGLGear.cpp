@@ -42,6 +42,7 @@ INCLUDES
 
 #include <cstdlib>
 #include <cstring>
+#include <cstdio>
 
 #include "math/FGFunction.h"
 #include "FGLGear.h"
@@ -69,6 +70,10 @@ IDENT(IdHdr,ID_LGEAR);
 const FGMatrix33 FGLGear::Tb2s(-1./inchtoft, 0., 0., 0., 1./inchtoft, 0., 0., 0., -1./inchtoft);
 const FGMatrix33 FGLGear::Ts2b(-inchtoft, 0., 0., 0., inchtoft, 0., 0., 0., -inchtoft);
 
+// Built at startup rather than on the first crash, which is detected in the
+// middle of the frame loop.
+static const string CrashMessage("Crash Detected: Simulation FREEZE.");
+
 /*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 CLASS IMPLEMENTATION
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
@@ -88,6 +93,7 @@ FGLGear::FGLGear(Element* el, FGFDMExec* fdmex, int number, const struct Inputs&
   eDampTypeRebound = dtLinear;
 
   name = el->GetAttributeValue("name");
+  ContactMessage.reserve(name.size() + 64);
   string sContactType = el->GetAttributeValue("type");
   if (sContactType == "BOGEY") {
     eContactType = ctBOGEY;
@@ -566,9 +572,14 @@ void FGLGear::ReportTakeoffOrLanding(void)
 
   if (lastWOW != WOW)
   {
-    ostringstream buf;
-    buf << "GEAR_CONTACT: " << fdmex->GetSimTime() << " seconds: " << name;
-    PutMessage(buf.str(), WOW);
+    // Built in a member string reserved at construction rather than in a
+    // stringstream, so that touching down and lifting off do not allocate.
+    // %g is the format an ostream gives a double by default.
+    char buf[64];
+    snprintf(buf, sizeof(buf), "GEAR_CONTACT: %g seconds: ", fdmex->GetSimTime());
+    ContactMessage.assign(buf);
+    ContactMessage += name;
+    PutMessage(ContactMessage, WOW);
   }
 }
 
@@ -582,7 +593,7 @@ void FGLGear::CrashDetect(void)
       GetMoments().Magnitude() > 5000000000.0 ||
       SinkRate > 1.4666*30 ) && !fdmex->IntegrationSuspended())
   {
-    PutMessage("Crash Detected: Simulation FREEZE.");
+    PutMessage(CrashMessage);
     // fdmex->SuspendIntegration();
   }
 }
@@ -361,6 +361,7 @@ private:
   bool Castered;
   bool StaticFriction;
   std::string name;
+  std::string ContactMessage;
 
   BrakeGroup  eBrakeGrp;
   ContactType eContactType;
@@ -183,7 +183,6 @@ void FGPropulsion::ConsumeFuel(FGEngine* engine)
 
   unsigned int TanksWithFuel=0, CurrentFuelTankPriority=1;
   unsigned int TanksWithOxidizer=0, CurrentOxidizerTankPriority=1;
-  vector <int> FeedListFuel, FeedListOxi;
   bool Starved = true; // Initially set Starved to true. Set to false in code below.
   bool hasOxTanks = false;
 
@@ -193,6 +192,11 @@ void FGPropulsion::ConsumeFuel(FGEngine* engine)
   //    increment CurrentPriority.
   // 3) Build the feed list.
   // 4) Do the same for oxidizer tanks, if needed.
+  // The feed lists are members that are cleared rather than rebuilt, so they
+  // keep their storage from one call to the next.
+
+  FeedListFuel.clear();
+  FeedListOxi.clear();
 
   // Process fuel tanks, if any
   while ((TanksWithFuel == 0) && (CurrentFuelTankPriority <= numTanks)) {
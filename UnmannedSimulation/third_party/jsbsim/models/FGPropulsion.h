@@ -200,6 +200,8 @@ public:
 private:
   std::vector <FGEngine*>   Engines;
   std::vector <FGTank*>     Tanks;
+  std::vector <int>         FeedListFuel;
+  std::vector <int>         FeedListOxi;
   unsigned int numSelectedFuelTanks;
   unsigned int numSelectedOxiTanks;
   unsigned int numFuelTanks;
@@ -0,0 +1,190 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+ Header:       FGEnvironment.h
+ Date started: 10/18/26
+
+ ------------- Copyright (C) 2026 -------------
+
+ This program is free software; you can redistribute it and/or modify it under
+ the terms of the GNU Lesser General Public License as published by the Free Software
+ Foundation; either version 2 of the License, or (at your option) any later
+ version.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ details.
+
+ You should have received a copy of the GNU Lesser General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ Place - Suite 330, Boston, MA  02111-1307, USA.
+
+ Further information about the GNU Lesser General Public License can also be found on
+ the world wide web at http://www.gnu.org.
+
+HISTORY
+--------------------------------------------------------------------------------
+10/18/26          Created
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+SENTRY
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef FGENVIRONMENT_H
+#define FGENVIRONMENT_H
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "FGJSBBase.h"
+#include "math/FGColumnVector3.h"
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#define ID_ENVIRONMENT "$Id: FGEnvironment.h,v 1.1 2026/10/18 00:00:00 Exp $"
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FORWARD DECLARATIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace JSBSim {
+
+class FGAtmosphere;
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DOCUMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/** Environment data shared by every FDM that is attached to it.
+    An FGFDMExec computes its own atmosphere and turbulence unless an
+    environment is attached with FGFDMExec::SetEnvironment(). Attached FDMs
+    then draw on two precomputed, read-only data sets instead:
+
+    - <b>Atmosphere tables.</b> Temperature and pressure tabulated against
+      altitude for a given weather. An atmosphere model that is a function of
+      altitude alone describes its current weather with a WeatherKey (see
+      FGAtmosphere::GetWeatherKey()); FDMs with the same weather share one
+      table, which is rebuilt only when the weather changes. Pressure is
+      interpolated logarithmically between nodes.
+
+    - <b>Turbulence field.</b> A frozen, three dimensional field of gust
+      velocities, tiled periodically through space and sampled by position.
+      FGWinds uses it when atmosphere/turb-type is 5 (ttField), so that
+      vehicles flying through the same air meet the same gusts. The field
+      has unit variance per component and a Dryden (exponential) correlation
+      with a scale length of 1750 ft, the MIL-F-8785C value above 2000 ft;
+      callers scale it to the desired intensity.
+
+    Both data sets are immutable once built, so FDMs running on several
+    threads can read them without locking. Only acquiring a table for a new
+    weather takes a lock.
+
+    A process normally uses the single instance returned by GetShared(). The
+    environment is not owned by the FDMs it is attached to and must outlive
+    them.
+*/
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DECLARATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+class FGEnvironment : public FGJSBBase
+{
+public:
+  /// Identifies the weather an atmosphere model is producing.
+  struct WeatherKey {
+    double Value[4];
+
+    WeatherKey(void) { for (int i=0; i<4; i++) Value[i] = 0.0; }
+    bool operator==(const WeatherKey& k) const;
+    bool operator!=(const WeatherKey& k) const { return !(*this == k); }
+    bool operator<(const WeatherKey& k) const;
+  };
+
+  /// Temperature and pressure tabulated against altitude above sea level.
+  class AtmosphereTable {
+  public:
+    /// Tabulates the model between MinAltitude and MaxAltitude (ft).
+    AtmosphereTable(const FGAtmosphere& model);
+
+    /// Returns true if the altitude lies within the table.
+    bool Covers(double altitude) const
+    { return altitude >= MinAltitude && altitude < MaxAltitude; }
+
+    /** Interpolates the temperature (deg R) and pressure (psf) at an
+        altitude covered by the table. */
+    void Lookup(double altitude, double& temperature, double& pressure) const;
+
+    static const double MinAltitude;
+    static const double MaxAltitude;
+    static const double Step;
+
+  private:
+    std::vector<double> Temperature;
+    std::vector<double> LogPressure;
+  };
+
+  /// Constructor. The turbulence field is generated from the given seed.
+  explicit FGEnvironment(unsigned int seed = 1);
+  /// Destructor
+  ~FGEnvironment();
+
+  /// Returns the process-wide environment.
+  static FGEnvironment& GetShared(void);
+
+  /** Returns the atmosphere table for a weather, building it from the model
+      if no attached FDM is currently using that weather.
+      @param name the name of the atmosphere model.
+      @param key the weather, as returned by model.GetWeatherKey().
+      @param model the atmosphere model producing the weather. */
+  std::shared_ptr<const AtmosphereTable>
+  GetAtmosphereTable(const std::string& name, const WeatherKey& key,
+                     const FGAtmosphere& model);
+
+  /** Samples the turbulence field at a batch of positions.
+      Positions are in feet in the Earth-centered, Earth-fixed frame, so that
+      every FDM indexes the field in the same way. The field is statistically
+      isotropic: the components of the returned velocities can be taken along
+      any orthonormal axes, such as the local north, east and down axes of the
+      vehicle. They have unit variance. The field is read-only, so FDMs on
+      several threads may sample it concurrently; FGWinds batches the points
+      of one FDM per call, not those of all attached FDMs.
+      @param positions the positions to sample at.
+      @param velocities receives one velocity per position.
+      @param count the number of positions. */
+  void SampleTurbulence(const FGColumnVector3* positions,
+                        FGColumnVector3* velocities, unsigned int count) const;
+
+  /// Returns the scale length of the turbulence field in feet.
+  double GetTurbulenceScaleLength(void) const { return ScaleLength; }
+
+private:
+  typedef std::pair<std::string, WeatherKey> TableId;
+
+  std::mutex TableLock;
+  std::map<TableId, std::weak_ptr<const AtmosphereTable> > Tables;
+
+  // Turbulence field, stored as one float per component and cell with the
+  // x index varying fastest.
+  static const unsigned int NX = 64, NY = 64, NZ = 32;
+  static const double ScaleLength;
+  double CellSize, rCellSize;
+  std::vector<float> Field[3];
+
+  void GenerateField(unsigned int seed);
+  void Debug(int from);
+};
+
+} // namespace JSBSim
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+#endif
@@ -367,6 +367,18 @@ void FGStandardAtmosphere::SetTemperatureGradedDelta(double deltemp, double h, e
   Run(false);
 }
 
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// The lapse rates and pressure breakpoints are derived from these three values
+// and the constant standard temperature table.
+
+bool FGStandardAtmosphere::GetWeatherKey(FGEnvironment::WeatherKey& key) const
+{
+  key.Value[0] = TemperatureBias;
+  key.Value[1] = TemperatureDeltaGradient;
+  key.Value[2] = PressureBreakpointVector[0];
+  return true;
+}
+
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 // This function calculates (or recalculates) the lapse rate over an altitude range
 // where the "bh" in this case refers to the index of the base height in the 
@@ -246,6 +246,10 @@ public:
   /// Prints the U.S. Standard Atmosphere table.
   virtual void PrintStandardAtmosphereTable();
 
+  /// Describes the weather by the temperature bias and graded delta and the
+  /// sea level pressure.
+  virtual bool GetWeatherKey(FGEnvironment::WeatherKey& key) const;
+
 protected:
   double StdSLtemperature, StdSLdensity, StdSLpressure, StdSLsoundspeed; // Standard sea level conditions
 
@@ -69,6 +69,7 @@ CLASS DOCUMENTATION
     - 2: ttCulp
     - 3: ttMilspec (Dryden spectrum)
     - 4: ttTustin (Dryden spectrum)
+    - 5: ttField (Dryden correlated field shared by all FDMs, see FGEnvironment)
 
     The Milspec and Tustin models are described in the Yeager report cited below.
     They both use a Dryden spectrum model whose parameters (scale lengths and intensities)
@@ -79,6 +80,18 @@ CLASS DOCUMENTATION
     The two models differ in the implementation of the transfer functions
     described in the milspec.
 
+    The Milspec and Tustin models filter white noise in time, so every vehicle
+    meets its own, unrelated gusts. The Field model instead samples the frozen
+    turbulence field of the FGEnvironment attached to the executive (or of the
+    process-wide one if none is attached), carried along by the mean wind.
+    Vehicles flying through the same air then meet the same gusts. Its
+    intensities follow MIL-F-8785C like the Milspec model and are set through
+    the same properties; its scale length is that of the field. The rotary
+    gusts are the gradients of the field across the wingspan. Each FDM samples
+    its own five points with one FGEnvironment::SampleTurbulence() call per
+    frame; the samples of different FDMs are not gathered into a single batch,
+    which would need every FDM to stop at the same point of its frame.
+
     To use one of these two models, set <tt>atmosphere/turb-type</tt> to 4 resp. 5,
     and specify values for <tt>atmosphere/turbulence/milspec/windspeed_at_20ft_AGL-fps<tt>
     and <tt>atmosphere/turbulence/milspec/severity<tt> (the latter corresponds to
@@ -132,7 +145,7 @@ public:
       @return false if no error */
   bool Run(bool Holding);
   bool InitModel(void);
-  enum tType {ttNone, ttStandard, ttCulp, ttMilspec, ttTustin} turbType;
+  enum tType {ttNone, ttStandard, ttCulp, ttMilspec, ttTustin, ttField} turbType;
 
   // TOTAL WIND access functions (wind + gust + turbulence)
 
@@ -196,7 +209,7 @@ public:
   /// Retrieves the gust components in NED frame.
   virtual const FGColumnVector3& GetGustNED(void) const {return vGustNED;}
 
-  /** Turbulence models available: ttNone, ttStandard, ttBerndt, ttCulp, ttMilspec, ttTustin */
+  /** Turbulence models available: ttNone, ttStandard, ttBerndt, ttCulp, ttMilspec, ttTustin, ttField */
   virtual void   SetTurbType(tType tt) {turbType = tt;}
   virtual tType  GetTurbType() const {return turbType;}
 
@@ -311,7 +324,9 @@ public:
     double longitude;
     double latitude;
     double planetRadius;
+    FGColumnVector3 vLocation;
     FGMatrix33 Tl2b;
+    FGMatrix33 Tl2ec;
     FGMatrix33 Tw2b;
     double totalDeltaT;
   } in;
@@ -335,7 +350,17 @@ private:
   // Dryden turbulence model
   double windspeed_at_20ft; ///< in ft/s
   int probability_of_exceedence_index; ///< this is bound as the severity property
-  FGTable *POE_Table; ///< probability of exceedence table
+
+  // Dryden filter states of the previous time steps
+  double xi_u_km1, nu_u_km1;
+  double xi_v_km1, xi_v_km2, nu_v_km1, nu_v_km2;
+  double xi_w_km1, xi_w_km2, nu_w_km1, nu_w_km2;
+  double xi_p_km1, nu_p_km1;
+  double xi_q_km1, xi_r_km1;
+
+  // Turbulence field stencil: the center and both ends of the body x and y axes
+  FGColumnVector3 FieldPositions[5];
+  FGColumnVector3 FieldGusts[5];
 
   double psiw;
   FGColumnVector3 vTotalWindNED;
@@ -346,6 +371,10 @@ private:
   FGColumnVector3 vTurbulenceNED;
 
   void Turbulence(double h);
+  void FieldTurbulence(double h);
+  void MilspecIntensities(double h, double& L_u, double& L_w,
+                          double& sig_u, double& sig_w) const;
+  void ResetDrydenFilters(void);
   void UpDownBurst();
 
   void CosineGust();
@@ -102,13 +102,13 @@ struct PathComponent
  * Parse the name for a path component.
  *
  * Name: [_a-zA-Z][-._a-zA-Z0-9]*
+ *
+ * The name is assigned into the caller's string so that its buffer
+ * can be reused from one parse to the next.
  */
-static inline const string
-parse_name (const string &path, int &i)
+static inline void
+parse_name (const char * path, int max, int &i, string &name)
 {
-  string name = "";
-  int max = (int)path.size();
-
   if (path[i] == '.') {
     i++;
     if (i < max && path[i] == '.') {
@@ -122,7 +122,7 @@ parse_name (const string &path, int &i)
   }
 
   else if (isalpha(path[i]) || path[i] == '_') {
-    name += path[i];
+    int start = i;
     i++;
 
 	      // The rules inside a name are a little
@@ -130,22 +130,19 @@ parse_name (const string &path, int &i)
     while (i < max) {
       if (isalpha(path[i]) || isdigit(path[i]) || path[i] == '_' ||
       path[i] == '-' || path[i] == '.') {
-        name += path[i];
+        i++;
       } else if (path[i] == '[' || path[i] == '/') {
         break;
       } else {
         throw string("name may contain only ._- and alphanumeric characters");
       }
-      i++;
     }
+    name.assign(path + start, i - start);
   }
 
   else {
-    if (name.size() == 0)
-      throw string("name must begin with alpha or '_'");
+    throw string("name must begin with alpha or '_'");
   }
-
-  return name;
 }
 
 
@@ -155,7 +152,7 @@ parse_name (const string &path, int &i)
  * Index: "[" [0-9]+ "]"
  */
 static inline int
-parse_index (const string &path, int &i)
+parse_index (const char * path, int max, int &i)
 {
   int index = 0;
 
@@ -164,7 +161,7 @@ parse_index (const string &path, int &i)
   else
     i++;
 
-  for (int max = (int)path.size(); i < max; i++) {
+  for (; i < max; i++) {
     if (isdigit(path[i])) {
       index = (index * 10) + (path[i] - '0');
     } else if (path[i] == ']') {
@@ -184,44 +181,60 @@ parse_index (const string &path, int &i)
  *
  * Component: Name Index?
  */
-static inline PathComponent
-parse_component (const string &path, int &i)
+static inline void
+parse_component (const char * path, int max, int &i, PathComponent &component)
 {
-  PathComponent component;
-  component.name = parse_name(path, i);
+  parse_name(path, max, i, component.name);
   if (component.name[0] != '.')
-    component.index = parse_index(path, i);
+    component.index = parse_index(path, max, i);
   else
     component.index = -1;
-  return component;
+}
+
+
+/**
+ * Return the next unused component of a path, reusing the entries
+ * (and their name buffers) left in the vector by a previous parse.
+ */
+static inline PathComponent &
+next_component (vector<PathComponent> &components, unsigned int &count)
+{
+  if (count == components.size())
+    components.push_back(PathComponent());
+  return components[count++];
 }
 
 
 /**
  * Parse a path into its components.
+ *
+ * The components vector may hold the result of a previous parse; it is
+ * overwritten in place and trimmed to the new number of components.
  */
 static void
-parse_path (const string &path, vector<PathComponent> &components)
+parse_path (const char * path, vector<PathComponent> &components)
 {
   int pos = 0;
-  int max = (int)path.size();
+  int max = (int)strlen(path);
+  unsigned int count = 0;
 
   // Check for initial '/'
   if (path[pos] == '/') {
-    PathComponent root;
-    root.name = "";
+    PathComponent &root = next_component(components, count);
+    root.name.clear();
     root.index = -1;
-    components.push_back(root);
     pos++;
     while (pos < max && path[pos] == '/')
       pos++;
   }
 
   while (pos < max) {
-    components.push_back(parse_component(path, pos));
+    parse_component(path, max, pos, next_component(components, count));
     while (pos < max && path[pos] == '/')
       pos++;
   }
+
+  components.resize(count);
 }
 
 
@@ -252,7 +265,7 @@ compare_strings (const char * s1, const char * s2)
  * Locate a child node by name and index.
  */
 static int
-find_child (const char * name, int index, vector<SGPropertyNode_ptr> nodes)
+find_child (const char * name, int index, const vector<SGPropertyNode_ptr> &nodes)
 {
   int nNodes = nodes.size();
   for (int i = 0; i < nNodes; i++) {
@@ -1736,9 +1749,20 @@ SGPropertyNode::getNode (const char * relative_path, bool create)
 
   SGPropertyNode * result = _path_cache->get(relative_path);
   if (result == 0) {
-    vector<PathComponent> components;
-    parse_path(relative_path, components);
-    result = find_node(this, components, 0, create);
+    if (create) {
+      vector<PathComponent> components;
+      parse_path(relative_path, components);
+      result = find_node(this, components, 0, create);
+    } else {
+      // Some models look up optional nodes on every frame. The path of
+      // a missing node is never cached, so parse it into a scratch vector
+      // that keeps its storage between calls. Nothing is created in this
+      // branch, hence no listener can call back into getNode() while the
+      // scratch vector is in use.
+      static thread_local vector<PathComponent> components;
+      parse_path(relative_path, components);
+      result = find_node(this, components, 0, create);
+    }
     if (result != 0)
       _path_cache->put(relative_path, result);
   }
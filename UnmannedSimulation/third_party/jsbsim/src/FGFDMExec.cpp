@@ -45,6 +45,15 @@ INCLUDES
 #include <iostream>
 #include <iterator>
 #include <cstdlib>
+#include <cmath>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#endif
 
 #include "FGFDMExec.h"
 #include "models/atmosphere/FGStandardAtmosphere.h"
@@ -53,6 +62,8 @@ INCLUDES
 #include "models/FGPropulsion.h"
 #include "models/FGMassBalance.h"
 #include "models/FGGroundReactions.h"
+#include "models/FGLGear.h"
+#include "models/propulsion/FGEngine.h"
 #include "models/FGExternalReactions.h"
 #include "models/FGBuoyantForces.h"
 #include "models/FGAerodynamics.h"
@@ -76,10 +87,60 @@ namespace JSBSim {
 IDENT(IdSrc,"$Id: FGFDMExec.cpp,v 1.181 2015/10/25 21:18:29 dpculp Exp $");
 IDENT(IdHdr,ID_FDMEXEC);
 
+// Quiescence counters of all the executives of the process that may sleep.
+// Both FleetExecutives and FleetAsleep only count executives with sleeping
+// enabled, so that the one never exceeds the other. The frames slept and the
+// CPU time saved are added in batches, so that sleeping executives on
+// different threads rarely write to them.
+static atomic<unsigned int> FleetExecutives(0);
+static atomic<unsigned int> FleetAsleep(0);
+static atomic<unsigned long long> FleetFramesSlept(0);
+static atomic<unsigned long long> FleetNanosecondsSaved(0);
+
+// The cost of a frame is timed on one frame out of this many.
+static const unsigned int SleepSampleInterval = 32;
+
+// With model timing on, the models are timed on one frame out of this many.
+static const unsigned int ModelTimingInterval = 32;
+
+// CPU time consumed so far by the calling thread, in seconds. Unlike the wall
+// clock, it does not advance while the thread is descheduled.
+static double ThreadCPUTime(void)
+{
+#if defined(_MSC_VER) || defined(__MINGW32__)
+  FILETIME creation, exit, kernel, user;
+  if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+    return 0.0;
+  ULARGE_INTEGER k, u;
+  k.LowPart = kernel.dwLowDateTime; k.HighPart = kernel.dwHighDateTime;
+  u.LowPart = user.dwLowDateTime;   u.HighPart = user.dwHighDateTime;
+  return (k.QuadPart + u.QuadPart)*1e-7;
+#else
+  timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0.0;
+  return ts.tv_sec + ts.tv_nsec*1e-9;
+#endif
+}
+
 /*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 CLASS IMPLEMENTATION
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
 
+// Listens to the property tree of an executive that may sleep: any value
+// written to it while it sleeps, by an input socket, a script event or the
+// application, wakes it up. The listener stays attached while the executive is
+// awake, where the flag is simply ignored, so that falling asleep and waking up
+// do not allocate.
+class FGFDMExec::WakeListener : public SGPropertyChangeListener
+{
+public:
+  explicit WakeListener(bool& wake) : WakeRequested(wake) {}
+  virtual void valueChanged(SGPropertyNode*) { WakeRequested = true; }
+
+private:
+  bool& WakeRequested;
+};
+
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 // Constructor
 
@@ -90,12 +151,40 @@ FGFDMExec::FGFDMExec(FGPropertyManager* root, unsigned int* fdmctr) : Root(root)
   IC              = 0;
   Trim            = 0;
   Script          = 0;
+  Environment     = 0;
   disperse        = 0;
 
+  Sleep.Enabled               = false;
+  Sleep.Asleep                = false;
+  Sleep.WakeRequested         = false;
+  Sleep.PrimeDerivatives      = false;
+  Sleep.SettledSince          = -1.0;
+  Sleep.SettleTime            = 2.0;
+  Sleep.VelocityThreshold     = 0.1;
+  Sleep.RateThreshold         = 0.001;
+  Sleep.AccelerationThreshold = 0.5;
+  Sleep.IdleThrottle          = 0.01;
+  Sleep.WindThreshold         = 5.0;
+  Sleep.DensityThreshold      = 0.01;
+  Sleep.Density               = 0.0;
+  Sleep.FramesSlept           = 0;
+  Sleep.UnreportedFrames      = 0;
+  Sleep.SampleCounter         = 0;
+  Sleep.AwakeCPUTime          = 0.0;
+  Sleep.AsleepCPUTime         = 0.0;
+  Sleep.AwakeSamples          = 0;
+  Sleep.AsleepSamples         = 0;
+  SleepListener = new WakeListener(Sleep.WakeRequested);
+
+  ModelTiming         = false;
+  ModelTimingCounter  = 0;
+  ModelTimingSamples  = 0;
+
   RootDir = "";
 
   modelLoaded = false;
   IsChild = false;
+  IODirectivesEnabled = true;
   holding = false;
   Terminate = false;
   StandAlone = false;
@@ -135,9 +224,28 @@ FGFDMExec::FGFDMExec(FGPropertyManager* root, unsigned int* fdmctr) : Root(root)
   // Prepare FDMctr for the next child FDM id
   (*FDMctr)++;       // instance. "child" instances are loaded last.
 
+
   FGPropertyNode* instanceRoot = Root->GetNode("/fdm/jsbsim",IdFDM,true);
   instance = new FGPropertyManager(instanceRoot);
 
+#ifdef JSBSIM_PROFILING
+  // The slot names follow the eModels enum order.
+  static const char* const ModelNames[eNumStandardModels] = {
+    "propagate", "input", "inertial", "atmosphere", "winds", "systems",
+    "mass-balance", "auxiliary", "propulsion", "aerodynamics",
+    "ground-reactions", "external-reactions", "buoyant-forces", "aircraft",
+    "accelerations", "output" };
+
+  Profiler = new FGProfiler(IdFDM);
+  Profiler->Bind(instance);
+  FrameSlot = Profiler->RegisterSlot(FGProfiler::eExec, "frame");
+  ScriptSlot = Profiler->RegisterSlot(FGProfiler::eExec, "script");
+  for (unsigned int i=0; i<eNumStandardModels; i++) {
+    ModelSlots.push_back(Profiler->RegisterSlot(FGProfiler::eModels, ModelNames[i]));
+    InputSlots.push_back(Profiler->RegisterSlot(FGProfiler::eInputs, ModelNames[i]));
+  }
+#endif
+
   try {
     char* num = getenv("JSBSIM_DISPERSE");
     if (num) {
@@ -176,6 +284,16 @@ FGFDMExec::FGFDMExec(FGPropertyManager* root, unsigned int* fdmctr) : Root(root)
   instance->Tie("simulation/jsbsim-debug", this, &FGFDMExec::GetDebugLevel, &FGFDMExec::SetDebugLevel);
   instance->Tie("simulation/frame", (int *)&Frame, false);
   instance->Tie("simulation/trim-completed", (int *)&trim_completed, false);
+  instance->Tie("simulation/sleep/enabled", this, &FGFDMExec::GetSleepEnabled, &FGFDMExec::SetSleepEnabled);
+  instance->Tie("simulation/sleep/asleep", this, &FGFDMExec::Asleep);
+  instance->Tie("simulation/sleep/frames-slept", this, &FGFDMExec::GetFramesSlept);
+  instance->Tie("simulation/sleep/settle-time-sec", &Sleep.SettleTime);
+  instance->Tie("simulation/sleep/velocity-threshold-fps", &Sleep.VelocityThreshold);
+  instance->Tie("simulation/sleep/rate-threshold-rad_sec", &Sleep.RateThreshold);
+  instance->Tie("simulation/sleep/acceleration-threshold-ft_sec2", &Sleep.AccelerationThreshold);
+  instance->Tie("simulation/sleep/idle-throttle", &Sleep.IdleThrottle);
+  instance->Tie("simulation/sleep/wind-threshold-fps", &Sleep.WindThreshold);
+  instance->Tie("simulation/sleep/density-threshold", &Sleep.DensityThreshold);
 
   // simplex trim properties
   instanceRoot->SetDouble("trim/solver/rtol",0.0001);
@@ -226,6 +344,9 @@ FGFDMExec::FGFDMExec(FGPropertyManager* root, unsigned int* fdmctr) : Root(root)
 
 FGFDMExec::~FGFDMExec()
 {
+  SetSleepEnabled(false);
+  delete SleepListener;
+
   try {
     Unbind();
     DeAllocate();
@@ -254,6 +375,10 @@ FGFDMExec::~FGFDMExec()
   
   SetGroundCallback(0);
 
+#ifdef JSBSIM_PROFILING
+  delete Profiler;
+#endif
+
   if (FDMctr > 0) (*FDMctr)--;
 
   Debug(1);
@@ -354,8 +479,18 @@ bool FGFDMExec::Run(void)
 {
   bool success=true;
 
+  FG_PROFILE_SCOPE(Profiler, FrameSlot);
+
   Debug(2);
 
+  // Only executives that may sleep time their frames, and only a sample of them.
+  bool timed = Sleep.Enabled && ++Sleep.SampleCounter % SleepSampleInterval == 0;
+  bool startedAsleep = Sleep.Asleep;
+  bool accelerated = false;
+  bool modelTimed = ModelTiming && ++ModelTimingCounter % ModelTimingInterval == 0;
+  if (modelTimed) ModelTimingSamples++;
+  double start = timed ? ThreadCPUTime() : 0.0;
+
   for (unsigned int i=1; i<ChildFDMList.size(); i++) {
     ChildFDMList[i]->AssignState( (FGPropagate*)Models[ePropagate] ); // Transfer state to the child FDM
     ChildFDMList[i]->Run();
@@ -364,11 +499,55 @@ bool FGFDMExec::Run(void)
   IncrTime();
 
   // returns true if success, false if complete
-  if (Script != 0 && !IntegrationSuspended()) success = Script->RunScript();
+  if (Script != 0 && !IntegrationSuspended()) {
+    FG_PROFILE_SCOPE(Profiler, ScriptSlot);
+    success = Script->RunScript();
+  }
+
+  if (Sleep.Asleep && Sleep.WakeRequested) WakeUp();
 
   for (unsigned int i = 0; i < Models.size(); i++) {
-    LoadInputs(i);
-    Models[i]->Run(holding);
+    // A sleeping executive only keeps the inputs, the environment and the
+    // outputs running, and carries the vehicle along with the planet.
+    if (Sleep.Asleep && i != ePropagate && i != eInput && i != eAtmosphere &&
+        i != eWinds && i != eOutput)
+      continue;
+
+    {
+      FG_PROFILE_SCOPE(Profiler, InputSlots[i]);
+      LoadInputs(i);
+    }
+    {
+      FG_PROFILE_SCOPE(Profiler, ModelSlots[i]);
+      chrono::steady_clock::time_point modelStart;
+      if (modelTimed) modelStart = chrono::steady_clock::now();
+      if (Sleep.Asleep && i == ePropagate)
+        Propagate->RunAtRest(holding);
+      else
+        Models[i]->Run(holding);
+      if (modelTimed)
+        ModelTimes[i] += chrono::duration<double>(chrono::steady_clock::now() - modelStart).count();
+    }
+    if (i == eAccelerations && !Sleep.Asleep && !holding) accelerated = true;
+
+    if (Sleep.Asleep) {
+      if (i == eWinds) {
+        if ((Winds->GetTotalWindNED() - Sleep.WindNED).Magnitude() > Sleep.WindThreshold ||
+            fabs(Atmosphere->GetDensity() - Sleep.Density) > Sleep.DensityThreshold*Sleep.Density)
+          Sleep.WakeRequested = true;
+      }
+      // Woken up by an input or by the environment: the models that follow
+      // run in full from this frame on.
+      if (Sleep.WakeRequested) WakeUp();
+    }
+  }
+
+  // Once the accelerations of an awakened vehicle have been computed again,
+  // the past derivatives are primed from them, as in Initialize().
+  if (Sleep.PrimeDerivatives && accelerated) {
+    LoadInputs(ePropagate);
+    Propagate->InitializeDerivatives();
+    Sleep.PrimeDerivatives = false;
   }
 
   if (ResetMode) {
@@ -378,6 +557,17 @@ bool FGFDMExec::Run(void)
     ResetToInitialConditions(mode);
   }
 
+  if (Sleep.Asleep) {
+    Sleep.FramesSlept++;
+    if (++Sleep.UnreportedFrames == SleepSampleInterval) ReportSleep();
+  } else if (Sleep.Enabled) {
+    CheckQuiescence();
+  }
+
+  if (timed)
+    RecordFrameCost(ThreadCPUTime() - start,
+                    startedAsleep && Sleep.Asleep);
+
   if (Terminate) success = false;
 
   return success;
@@ -406,7 +596,9 @@ void FGFDMExec::LoadInputs(unsigned int idx)
   case eWinds:
     Winds->in.AltitudeASL      = Propagate->GetAltitudeASL();
     Winds->in.DistanceAGL      = Propagate->GetDistanceAGL();
+    Winds->in.vLocation        = Propagate->GetLocation();
     Winds->in.Tl2b             = Propagate->GetTl2b();
+    Winds->in.Tl2ec            = Propagate->GetTl2ec();
     Winds->in.Tw2b             = Auxiliary->GetTw2b();
     Winds->in.V                = Auxiliary->GetVt();
     Winds->in.totalDeltaT      = dT * Winds->GetRate();
@@ -599,6 +791,9 @@ bool FGFDMExec::RunIC(void)
 {
   FGPropulsion* propulsion = (FGPropulsion*)Models[ePropulsion];
 
+  if (Sleep.Asleep) WakeUp();
+  Sleep.SettledSince = -1.0;
+
   SuspendIntegration(); // saves the integration rate, dt, then sets it to 0.0.
   Initialize(IC);
 
@@ -870,7 +1065,7 @@ bool FGFDMExec::LoadModel(const string& model, bool addModelToPath)
     }
 
     // Process the input element. This element is OPTIONAL, and there may be more than one.
-    element = document->FindElement("input");
+    element = IODirectivesEnabled ? document->FindElement("input") : 0L;
     while (element) {
       if (!static_cast<FGInput*>(Models[eInput])->Load(element))
         return false;
@@ -880,7 +1075,7 @@ bool FGFDMExec::LoadModel(const string& model, bool addModelToPath)
 
     // Process the output element[s]. This element is OPTIONAL, and there may be
     // more than one.
-    element = document->FindElement("output");
+    element = IODirectivesEnabled ? document->FindElement("output") : 0L;
     while (element) {
       if (!static_cast<FGOutput*>(Models[eOutput])->Load(element))
         return false;
@@ -1097,6 +1292,7 @@ bool FGFDMExec::ReadChild(Element* el)
 
   child->exec = new FGFDMExec(Root, FDMctr);
   child->exec->SetChild(true);
+  child->exec->SetEnvironment(Environment);
 
   string childAircraft = el->GetAttributeValue("name");
   string sMated = el->GetAttributeValue("mated");
@@ -1147,6 +1343,191 @@ FGTrim* FGFDMExec::GetTrim(void)
 
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 
+void FGFDMExec::SetEnvironment(FGEnvironment* env)
+{
+  Environment = env;
+
+  for (unsigned int i=0; i<ChildFDMList.size(); i++)
+    ChildFDMList[i]->exec->SetEnvironment(env);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void FGFDMExec::SetSleepEnabled(bool enabled)
+{
+  if (enabled == Sleep.Enabled) return;
+
+  Sleep.Enabled = enabled;
+  Sleep.SettledSince = -1.0;
+
+  if (enabled) {
+    instance->GetNode()->addChangeListener(SleepListener);
+    FleetExecutives++;
+  } else {
+    if (Sleep.Asleep) WakeUp();
+    instance->GetNode()->removeChangeListener(SleepListener);
+    FleetExecutives--;
+  }
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// The times are accumulated per model slot, so the vector is sized here rather
+// than on the timed frames.
+
+void FGFDMExec::SetModelTiming(bool enabled)
+{
+  ModelTiming = enabled;
+  ModelTimingCounter = 0;
+  ModelTimingSamples = 0;
+  ModelTimes.assign(Models.size(), 0.0);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+double FGFDMExec::GetModelNsPerFrame(unsigned int model) const
+{
+  if (ModelTimingSamples == 0 || model >= ModelTimes.size()) return 0.0;
+  return ModelTimes[model]*1e9/ModelTimingSamples;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+FGFDMExec::SleepStatistics FGFDMExec::GetSleepStatistics(void)
+{
+  SleepStatistics stats;
+  unsigned int executives = FleetExecutives.load();
+
+  stats.Asleep = FleetAsleep.load();
+  // The two counters are read separately: an executive that stops sleeping on
+  // another thread in between may still be counted asleep.
+  stats.Awake = executives > stats.Asleep ? executives - stats.Asleep : 0;
+  stats.FramesSlept = FleetFramesSlept.load();
+  stats.CPUSaved = FleetNanosecondsSaved.load()*1e-9;
+
+  return stats;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Only a vehicle resting on its own gear, with nothing left to drive it, may
+// sleep. Child FDMs follow their parent and are never put to sleep on their
+// own, nor is a parent carrying them.
+
+bool FGFDMExec::Settled(void) const
+{
+  if (holding || IsChild || IntegrationSuspended() || ResetMode || !ChildFDMList.empty())
+    return false;
+
+  if (Propagate->GetUVW().Magnitude() > Sleep.VelocityThreshold ||
+      Propagate->GetPQR().Magnitude() > Sleep.RateThreshold ||
+      Accelerations->GetUVWdot().Magnitude() > Sleep.AccelerationThreshold)
+    return false;
+
+  int bogeys = 0;
+  for (int i=0; i<GroundReactions->GetNumGearUnits(); i++) {
+    FGLGear* gear = GroundReactions->GetGearUnit(i);
+    if (!gear->IsBogey()) continue;
+    if (!gear->GetWOW()) return false;
+    bogeys++;
+  }
+  if (bogeys == 0) return false;
+
+  for (unsigned int i=0; i<Propulsion->GetNumEngines(); i++) {
+    FGEngine* engine = Propulsion->GetEngine(i);
+    if (engine->GetStarter()) return false;
+    if (engine->GetRunning()) {
+      double range = engine->GetThrottleMax() - engine->GetThrottleMin();
+      if (FCS->GetThrottlePos(i) > engine->GetThrottleMin() + Sleep.IdleThrottle*range)
+        return false;
+    }
+  }
+
+  if (Script && Script->HasPendingEvents()) return false;
+
+  return true;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void FGFDMExec::CheckQuiescence(void)
+{
+  if (!Settled()) {
+    Sleep.SettledSince = -1.0;
+    return;
+  }
+
+  if (Sleep.SettledSince < 0.0)
+    Sleep.SettledSince = sim_time;
+  else if (sim_time - Sleep.SettledSince >= Sleep.SettleTime)
+    FallAsleep();
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// The environment the vehicle fell asleep in is kept so that a change of wind
+// or density large enough to move it can wake it up.
+
+void FGFDMExec::FallAsleep(void)
+{
+  Sleep.Asleep = true;
+  Sleep.WakeRequested = false;
+  Sleep.WindNED = Winds->GetTotalWindNED();
+  Sleep.Density = Atmosphere->GetDensity();
+
+  FleetAsleep++;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void FGFDMExec::WakeUp(void)
+{
+  ReportSleep();
+
+  Sleep.Asleep = false;
+  Sleep.WakeRequested = false;
+  Sleep.SettledSince = -1.0;
+  FleetAsleep--;
+
+  // The past derivatives date from before the vehicle fell asleep, and the
+  // inertial velocity has turned with the planet since. They are reset to the
+  // current state until Run() primes them with fresh accelerations.
+  Propagate->InitializeDerivatives();
+  Sleep.PrimeDerivatives = true;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Each frame slept saves the mean cost of an awake frame less that of a
+// sleeping one, as sampled so far. Nothing is counted as saved until both have
+// been sampled.
+
+void FGFDMExec::ReportSleep(void)
+{
+  if (Sleep.UnreportedFrames == 0) return;
+
+  double saved = 0.0;
+  if (Sleep.AwakeSamples > 0 && Sleep.AsleepSamples > 0)
+    saved = Sleep.UnreportedFrames*(Sleep.AwakeCPUTime/Sleep.AwakeSamples -
+                                    Sleep.AsleepCPUTime/Sleep.AsleepSamples);
+
+  FleetFramesSlept += Sleep.UnreportedFrames;
+  if (saved > 0.0) FleetNanosecondsSaved += (unsigned long long)(saved*1e9);
+
+  Sleep.UnreportedFrames = 0;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void FGFDMExec::RecordFrameCost(double seconds, bool asleep)
+{
+  if (asleep) {
+    Sleep.AsleepCPUTime += seconds;
+    Sleep.AsleepSamples++;
+  } else {
+    Sleep.AwakeCPUTime += seconds;
+    Sleep.AwakeSamples++;
+  }
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
 void FGFDMExec::CheckIncrementalHold(void)
 {
   // Only check if increment then hold is on
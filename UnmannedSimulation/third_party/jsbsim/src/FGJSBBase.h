@@ -39,7 +39,7 @@ INCLUDES
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
 
 #include <float.h>
-#include <queue>
+#include <vector>
 #include <string>
 #include <cmath>
 
@@ -172,14 +172,26 @@ public:
   void PutMessage(const std::string& text, double dVal);
   /** Reads the message on the queue (but does not delete it).
       @return 1 if some messages */
-  int SomeMessages(void) { return !Messages.empty(); }
+  int SomeMessages(void);
   /** Reads the message on the queue and removes it from the queue.
-      This function also prints out the message.*/
+      This function also prints out the message. The messages are printed
+      one at a time, outside of the lock that guards the queue, so that
+      posting a message never waits on the console.*/
   void ProcessMessage(void);
   /** Reads the next message on the queue and removes it from the queue.
-      This function also prints out the message.
+      The message is held in a buffer shared by the whole process: it is
+      overwritten by the next call, from any thread.
       @return a pointer to the message, or NULL if there are no messages.*/
   Message* ProcessNextMessage(void);
+  /** Moves the next message on the queue into a caller-owned buffer and
+      removes it from the queue. The strings are swapped, so a buffer reused
+      from call to call does not allocate.
+      @param msg the buffer receiving the message
+      @return false if there are no messages.*/
+  bool ProcessNextMessage(Message& msg);
+  /** Returns how many messages were dropped, over the whole process, because
+      the queue was full when they were posted. */
+  static unsigned int GetDroppedMessages(void);
   //@}
 
   /** Returns the version number of JSBSim.
@@ -331,7 +343,24 @@ public:
 protected:
   static Message localMsg;
 
-  static std::queue <Message> Messages;
+  /** The message queue is a fixed ring of reusable Message slots: posting a
+      message assigns into a slot (and into the capacity of its strings)
+      instead of allocating a new entry. When nobody drains the queue and the
+      ring is full, the oldest message is dropped to make room for the new one
+      and DroppedMessages is incremented. */
+  static std::vector <Message> Messages;
+  static unsigned int MessageHead;
+  static unsigned int MessageCount;
+  static unsigned int DroppedMessages;
+  static Message& NextMessageSlot(void);
+  /** Rewinding to the first slot whenever the ring empties means that a
+      queue drained every frame keeps reusing the same few slots.
+      MessageLock must be held. */
+  static void PopMessage(void)
+  {
+    if (--MessageCount == 0) MessageHead = 0;
+    else MessageHead = (MessageHead + 1) % Messages.size();
+  }
 
   void Debug(int) {};
 
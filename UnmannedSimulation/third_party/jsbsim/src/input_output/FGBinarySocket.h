@@ -0,0 +1,154 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+ Header:       FGBinarySocket.h
+ Date started: 10/18/26
+
+ ------------- Copyright (C) 2026 -------------
+
+ This program is free software; you can redistribute it and/or modify it under
+ the terms of the GNU Lesser General Public License as published by the Free Software
+ Foundation; either version 2 of the License, or (at your option) any later
+ version.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ details.
+
+ You should have received a copy of the GNU Lesser General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ Place - Suite 330, Boston, MA  02111-1307, USA.
+
+ Further information about the GNU Lesser General Public License can also be found on
+ the world wide web at http://www.gnu.org.
+
+HISTORY
+--------------------------------------------------------------------------------
+10/18/26          Created
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+SENTRY
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef FGBINARYSOCKET_H
+#define FGBINARYSOCKET_H
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include <string>
+#include <vector>
+
+#include "FGInputType.h"
+#include "input_output/FGfdmSocket.h"
+#include "input_output/FGPropertyProtocol.h"
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#define ID_BINARYSOCKET "$Id: FGBinarySocket.h,v 1.1 2026/10/18 00:00:00 Exp $"
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FORWARD DECLARATIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace JSBSim {
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DOCUMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/** Serves the binary property session protocol (see FGPropertyProtocol) on a
+    socket. This is the binary counterpart of FGInputSocket and
+    FGOutputSocket: a client registers the properties it needs once, then
+    sets them and receives their changes by ID, rate limited and without any
+    text being formatted or parsed.
+
+    Subscriptions are published at the rate of the input, from the values the
+    properties have when it runs, i.e. at the end of the previous frame.
+    Update times are simulation times, and so are subscription periods.
+
+    A session lives as long as its TCP connection, or for UDP as long as
+    datagrams come from the same peer. The socket itself is opened once and
+    kept across FGFDMExec::RunIC().
+
+    Usage:
+@code
+<input type="BINARY" port="5140" protocol="TCP" rate="60"/>
+@endcode
+    The protocol is "TCP" (the default) or "UDP". Without a rate, the input
+    runs every frame.
+ */
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DECLARATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+class FGBinarySocket : public FGInputType
+{
+public:
+  /** Constructor. */
+  FGBinarySocket(FGFDMExec* fdmex);
+
+  /** Destructor. */
+  ~FGBinarySocket();
+
+  /** Init the input directives from an XML file.
+      @param element XML Element that is pointing to the input directives
+  */
+  bool Load(Element* el);
+
+  /** Initializes the instance. This method opens the socket on its first
+      call; later calls keep it and the session it is serving.
+      @result true if the execution succeeded.
+   */
+  bool InitModel(void);
+
+  /// Applies the client's messages and sends it the changes it subscribed to.
+  void Read(bool Holding);
+
+protected:
+  typedef FGPropertyProtocol Protocol;
+
+  struct Registration {
+    FGPropertyNode_ptr node;
+    bool subscribed;
+    bool fresh;          // subscribed and not published yet
+    double period;
+    double deadband;
+    double published;    // last value sent
+    double publishedAt;  // simulation time it was sent at
+  };
+
+  void ResetSession(void);
+  void Dispatch(uint8_t type, Protocol::Reader& in);
+  void Register(Protocol::Reader& in);
+  void Publish(void);
+  void Flush(void);
+
+  /// Adds an entry to the UPDATE being written, starting it if need be.
+  void AddUpdate(Protocol::Writer& out, double time, uint16_t id, double value);
+  void EndUpdate(Protocol::Writer& out);
+
+  bool ValidID(uint16_t id) const
+  { return id < Registrations.size() && Registrations[id].node; }
+
+  unsigned int SockPort;
+  FGfdmSocket::ProtocolType SockProtocol;
+  FGfdmSocket* socket;
+  unsigned int Connection;
+  bool Greeted;
+  size_t UpdateCount;
+  size_t UpdateStart;
+  size_t UpdateMark;
+
+  std::vector<Registration> Registrations;
+  std::vector<uint8_t> Inbound;
+  std::vector<uint8_t> Outbound;
+  std::string Path;
+};
+}
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+#endif
@@ -0,0 +1,401 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+ Module:       FGProfiler.cpp
+ Date started: 10/18/26
+ Purpose:      Accumulates hot-path timings for an FDM instance
+
+ ------------- Copyright (C) 2026 -------------
+
+ This program is free software; you can redistribute it and/or modify it under
+ the terms of the GNU Lesser General Public License as published by the Free Software
+ Foundation; either version 2 of the License, or (at your option) any later
+ version.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ details.
+
+ You should have received a copy of the GNU Lesser General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ Place - Suite 330, Boston, MA  02111-1307, USA.
+
+ Further information about the GNU Lesser General Public License can also be found on
+ the world wide web at http://www.gnu.org.
+
+FUNCTIONAL DESCRIPTION
+--------------------------------------------------------------------------------
+This class keeps per-slot timing statistics for one FGFDMExec and collects
+trace events that can be exported in the Chrome trace event format.
+
+HISTORY
+--------------------------------------------------------------------------------
+10/18/26          Created
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include "FGProfiler.h"
+
+#ifdef JSBSIM_PROFILING
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+
+#include "FGJSBBase.h"
+#include "FGPropertyManager.h"
+
+using namespace std;
+
+namespace JSBSim {
+
+IDENT(IdSrc,"$Id: FGProfiler.cpp,v 1.1 2026/10/18 00:00:00 Exp $");
+IDENT(IdHdr,ID_PROFILER);
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+GLOBAL DATA
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace {
+
+// Every live profiler, so that a trace can be written for all the FDMs of the
+// process regardless of the thread each of them is run from.
+mutex& RegistryLock(void)
+{
+  static mutex m;
+  return m;
+}
+
+set<FGProfiler*>& Registry(void)
+{
+  static set<FGProfiler*> s;
+  return s;
+}
+
+// Small sequential thread ids are easier to read in a trace viewer than the
+// values of std::thread::id.
+unsigned int CurrentThreadId(void)
+{
+  static atomic<unsigned int> next(1);
+  thread_local unsigned int tid = next++;
+  return tid;
+}
+
+const chrono::steady_clock::time_point& Epoch(void)
+{
+  static const chrono::steady_clock::time_point epoch = chrono::steady_clock::now();
+  return epoch;
+}
+
+string JSONEscape(const string& s)
+{
+  string out;
+  for (unsigned int i=0; i<s.size(); i++) {
+    if (s[i] == '"' || s[i] == '\\') out += '\\';
+    out += s[i];
+  }
+  return out;
+}
+
+}
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS IMPLEMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+FGProfiler::FGProfiler(unsigned int fdmId)
+  : IdFDM(fdmId), enabled(true), tracing(false), PropertyManager(0),
+    TraceCapacity(65536), TraceHead(0)
+{
+  Epoch();
+
+  lock_guard<mutex> guard(RegistryLock());
+  Registry().insert(this);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+FGProfiler::~FGProfiler()
+{
+  lock_guard<mutex> guard(RegistryLock());
+  Registry().erase(this);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+long long FGProfiler::Now(void)
+{
+  return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now()
+                                                    - Epoch()).count();
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+const char* FGProfiler::CategoryName(eCategory category)
+{
+  switch(category) {
+  case eExec:      return "exec";
+  case eModels:    return "models";
+  case eInputs:    return "inputs";
+  case eChannels:  return "channels";
+  case eFunctions: return "functions";
+  default:         return "other";
+  }
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+int FGProfiler::RegisterSlot(eCategory category, const string& name)
+{
+  // Property names only accept a restricted set of characters. Slashes are
+  // kept so that function names such as aero/coefficient/CLalpha map to the
+  // same hierarchy as the function properties themselves.
+  string clean = name.empty() ? string("unnamed") : name;
+  for (unsigned int i=0; i<clean.size(); i++) {
+    char c = clean[i];
+    if (!isalnum(c) && c != '-' && c != '_' && c != '.' && c != '/')
+      clean[i] = '-';
+  }
+
+  string key = string(CategoryName(category)) + "/" + clean;
+  map<string, int>::const_iterator it = SlotIndex.find(key);
+  if (it != SlotIndex.end()) return it->second;
+
+  Slot s;
+  s.category = category;
+  s.name = clean;
+  ClearSlot(s);
+
+  // WriteChromeTrace() reads the slots from another thread under TraceLock,
+  // so the vector may only grow while it is held.
+  int slot;
+  {
+    lock_guard<mutex> guard(TraceLock);
+    Slots.push_back(s);
+    slot = (int)Slots.size() - 1;
+  }
+
+  SlotIndex[key] = slot;
+  if (PropertyManager) BindSlot(slot);
+
+  return slot;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void FGProfiler::ClearSlot(Slot& s)
+{
+  s.calls = 0;
+  s.total = 0;
+  s.min = 0;
+  s.max = 0;
+  for (unsigned int i=0; i<eNumBuckets; i++) s.histogram[i] = 0;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void FGProfiler::Record(int slot, long long start, long long stop)
+{
+  Slot& s = Slots[slot];
+  long long dt = stop - start;
+
+  if (s.calls == 0 || dt < s.min) s.min = dt;
+  if (dt > s.max) s.max = dt;
+  s.total += dt;
+  s.calls++;
+
+  unsigned int bucket = 0;
+  for (unsigned long long v = (unsigned long long)dt; v > 1 && bucket < eNumBuckets-1; v >>= 1)
+    bucket++;
+  s.histogram[bucket]++;
+
+  if (tracing) {
+    TraceEvent ev;
+    ev.slot = slot;
+    ev.tid = CurrentThreadId();
+    ev.start = start;
+    ev.duration = dt;
+
+    lock_guard<mutex> guard(TraceLock);
+    if (Trace.size() < TraceCapacity) {
+      Trace.push_back(ev);
+    } else {
+      Trace[TraceHead] = ev;
+      TraceHead = (TraceHead + 1) % TraceCapacity;
+    }
+  }
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void FGProfiler::SetTraceCapacity(unsigned int n)
+{
+  lock_guard<mutex> guard(TraceLock);
+  TraceCapacity = max(n, 1u);
+  Trace.clear();
+  Trace.reserve(TraceCapacity);
+  TraceHead = 0;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void FGProfiler::Reset(void)
+{
+  for (unsigned int i=0; i<Slots.size(); i++) ClearSlot(Slots[i]);
+
+  lock_guard<mutex> guard(TraceLock);
+  Trace.clear();
+  TraceHead = 0;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+double FGProfiler::GetMeanUs(int slot) const
+{
+  const Slot& s = Slots[slot];
+  return s.calls ? s.total*1e-3/s.calls : 0.0;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+double FGProfiler::GetMinUs(int slot) const
+{
+  return Slots[slot].min*1e-3;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// The estimate is the upper bound of the histogram bucket that holds the
+// requested fraction of the calls, clipped to the observed maximum.
+
+double FGProfiler::GetPercentileUs(int slot, double fraction) const
+{
+  const Slot& s = Slots[slot];
+  if (s.calls == 0) return 0.0;
+
+  unsigned long long target = (unsigned long long)(fraction*s.calls);
+  unsigned long long count = 0;
+
+  for (unsigned int i=0; i<eNumBuckets; i++) {
+    count += s.histogram[i];
+    if (count > target) {
+      double upper = (double)(2ULL << i);
+      return min(upper, (double)s.max)*1e-3;
+    }
+  }
+
+  return s.max*1e-3;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void FGProfiler::Bind(FGPropertyManager* pm)
+{
+  PropertyManager = pm;
+
+  PropertyManager->Tie("profiling/enabled", this, &FGProfiler::GetEnabled,
+                       &FGProfiler::SetEnabled);
+  PropertyManager->Tie("profiling/tracing", this, &FGProfiler::GetTracing,
+                       &FGProfiler::SetTracing);
+
+  for (unsigned int i=0; i<Slots.size(); i++) BindSlot(i);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void FGProfiler::BindSlot(int slot)
+{
+  typedef double (FGProfiler::*PMF)(int) const;
+  const Slot& s = Slots[slot];
+  string base = string("profiling/") + CategoryName(s.category) + "/" + s.name;
+
+  PropertyManager->Tie(base + "/calls", this, slot, (PMF)&FGProfiler::GetCalls);
+  PropertyManager->Tie(base + "/total-ms", this, slot, (PMF)&FGProfiler::GetTotalMs);
+  PropertyManager->Tie(base + "/mean-us", this, slot, (PMF)&FGProfiler::GetMeanUs);
+  PropertyManager->Tie(base + "/min-us", this, slot, (PMF)&FGProfiler::GetMinUs);
+  PropertyManager->Tie(base + "/max-us", this, slot, (PMF)&FGProfiler::GetMaxUs);
+  PropertyManager->Tie(base + "/p50-us", this, slot, (PMF)&FGProfiler::GetP50Us);
+  PropertyManager->Tie(base + "/p99-us", this, slot, (PMF)&FGProfiler::GetP99Us);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+string FGProfiler::GetReport(unsigned int topN) const
+{
+  ostringstream buf;
+  buf << fixed << setprecision(3);
+  buf << "Profile of FDM " << IdFDM << endl;
+
+  for (int cat=0; cat<eNumCategories; cat++) {
+    vector< pair<long long, int> > sorted;
+    for (unsigned int i=0; i<Slots.size(); i++)
+      if (Slots[i].category == cat && Slots[i].calls > 0)
+        sorted.push_back(make_pair(Slots[i].total, (int)i));
+    if (sorted.empty()) continue;
+
+    sort(sorted.rbegin(), sorted.rend());
+    if (cat == eFunctions && sorted.size() > topN) sorted.resize(topN);
+
+    buf << "  " << CategoryName((eCategory)cat) << ":" << endl;
+    for (unsigned int i=0; i<sorted.size(); i++) {
+      int slot = sorted[i].second;
+      buf << "    " << left << setw(40) << Slots[slot].name << right
+          << " calls " << setw(9) << Slots[slot].calls
+          << "  total " << setw(10) << GetTotalMs(slot) << " ms"
+          << "  mean " << setw(9) << GetMeanUs(slot) << " us"
+          << "  p99 " << setw(9) << GetP99Us(slot) << " us"
+          << "  max " << setw(9) << GetMaxUs(slot) << " us" << endl;
+    }
+  }
+
+  return buf.str();
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+bool FGProfiler::WriteChromeTrace(const string& fname)
+{
+  ofstream out(fname.c_str());
+  if (!out.is_open()) return false;
+
+  out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  out << fixed << setprecision(3);
+
+  bool first = true;
+  lock_guard<mutex> registryGuard(RegistryLock());
+  set<FGProfiler*>::const_iterator it;
+
+  for (it = Registry().begin(); it != Registry().end(); ++it) {
+    FGProfiler* p = *it;
+    lock_guard<mutex> traceGuard(p->TraceLock);
+
+    for (unsigned int i=0; i<p->Trace.size(); i++) {
+      const TraceEvent& ev = p->Trace[(p->TraceHead + i) % p->Trace.size()];
+      const Slot& s = p->Slots[ev.slot];
+
+      if (!first) out << ",";
+      first = false;
+
+      // Timestamps are expressed in microseconds by the trace format.
+      out << "\n{\"name\":\"" << JSONEscape(s.name) << "\""
+          << ",\"cat\":\"" << CategoryName(s.category) << "\""
+          << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << ev.tid
+          << ",\"ts\":" << ev.start*1e-3
+          << ",\"dur\":" << ev.duration*1e-3
+          << ",\"args\":{\"fdm\":" << p->IdFDM << "}}";
+    }
+  }
+
+  out << "\n]}" << endl;
+  return out.good();
+}
+
+} // namespace JSBSim
+
+#endif // JSBSIM_PROFILING
@@ -0,0 +1,247 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+ Header:       FGProfiler.h
+ Date started: 10/18/26
+
+ ------------- Copyright (C) 2026 -------------
+
+ This program is free software; you can redistribute it and/or modify it under
+ the terms of the GNU Lesser General Public License as published by the Free Software
+ Foundation; either version 2 of the License, or (at your option) any later
+ version.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ details.
+
+ You should have received a copy of the GNU Lesser General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ Place - Suite 330, Boston, MA  02111-1307, USA.
+
+ Further information about the GNU Lesser General Public License can also be found on
+ the world wide web at http://www.gnu.org.
+
+HISTORY
+--------------------------------------------------------------------------------
+10/18/26          Created
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+SENTRY
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#ifndef FGPROFILER_H
+#define FGPROFILER_H
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+DEFINITIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#define ID_PROFILER "$Id: FGProfiler.h,v 1.1 2026/10/18 00:00:00 Exp $"
+
+// The profiler is compiled out unless JSBSIM_PROFILING is defined. When it is
+// compiled out the scope macro expands to nothing and no FGProfiler instance
+// is ever created, so the executive runs exactly as it did before.
+
+#define FG_PROFILE_CONCAT_(a,b) a##b
+#define FG_PROFILE_CONCAT(a,b) FG_PROFILE_CONCAT_(a,b)
+
+#ifdef JSBSIM_PROFILING
+#  define FG_PROFILE_SCOPE(profiler, slot) \
+     JSBSim::FGProfileTimer FG_PROFILE_CONCAT(profileTimer, __LINE__)((profiler), (slot))
+#else
+#  define FG_PROFILE_SCOPE(profiler, slot)
+#endif
+
+#ifdef JSBSIM_PROFILING
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+FORWARD DECLARATIONS
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+namespace JSBSim {
+
+class FGPropertyManager;
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DOCUMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+/** Accumulates hot-path timings for one FGFDMExec instance.
+    Each timed section of the executive (a model's Run(), a LoadInputs() call,
+    an FCS channel, a top-level aerodynamic function, the script) is a "slot".
+    Slots are registered once at load time and afterwards recorded through
+    FGProfileTimer, which costs two reads of std::chrono::steady_clock and a few
+    integer updates.
+
+    For every slot the profiler keeps the call count, the total, minimum and
+    maximum durations and a log2 histogram of durations in nanoseconds from
+    which percentiles are estimated.
+
+    When tracing is switched on, each recorded section is also appended to a
+    bounded ring of trace events. WriteChromeTrace() merges the rings of every
+    live profiler in the process - whatever thread their FDM runs on - into a
+    single Chrome trace / Perfetto JSON file.
+
+    The profiler requires a C++11 compiler and is only built when
+    JSBSIM_PROFILING is defined.
+
+    <h3>Properties</h3>
+    @property profiling/enabled (read/write) Set to 0 to stop recording.
+    @property profiling/tracing (read/write) Set to 1 to record trace events.
+    @property profiling/[category]/[name]/calls (read only) Number of calls
+    @property profiling/[category]/[name]/total-ms (read only) Accumulated time
+    @property profiling/[category]/[name]/mean-us (read only) Mean call time
+    @property profiling/[category]/[name]/min-us (read only) Fastest call
+    @property profiling/[category]/[name]/max-us (read only) Slowest call
+    @property profiling/[category]/[name]/p50-us (read only) Median estimate
+    @property profiling/[category]/[name]/p99-us (read only) 99th percentile estimate
+
+    where [category] is one of exec, models, inputs, channels or functions.
+*/
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS DECLARATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+class FGProfiler
+{
+public:
+  enum eCategory { eExec=0, eModels, eInputs, eChannels, eFunctions,
+                   eNumCategories };
+
+  /** Constructor
+      @param fdmId the ID of the owning FDM, used to label trace events */
+  FGProfiler(unsigned int fdmId);
+  ~FGProfiler();
+
+  /** Returns the current time of the profiling clock in nanoseconds. */
+  static long long Now(void);
+
+  /** Registers a timed section and ties its statistics to the property tree.
+      Registering the same name twice in a category returns the same slot.
+      @param category the category the slot is reported under
+      @param name the name of the slot
+      @return the slot index to pass to Record() or FG_PROFILE_SCOPE */
+  int RegisterSlot(eCategory category, const std::string& name);
+
+  /** Records one timed call.
+      @param slot a slot index returned by RegisterSlot()
+      @param start the clock value at the start of the call
+      @param stop the clock value at the end of the call */
+  void Record(int slot, long long start, long long stop);
+
+  /** Ties the profiling/ properties. Slots registered later are tied as they
+      are registered. */
+  void Bind(FGPropertyManager* pm);
+
+  /** Clears all accumulated statistics and trace events. Slots are kept. */
+  void Reset(void);
+
+  bool Enabled(void) const {return enabled;}
+  void SetEnabled(bool state) {enabled = state;}
+  bool GetEnabled(void) const {return enabled;}
+  bool GetTracing(void) const {return tracing;}
+  void SetTracing(bool state) {tracing = state;}
+
+  /** Sets the number of trace events kept per FDM. The oldest events are
+      overwritten once the ring is full. */
+  void SetTraceCapacity(unsigned int n);
+
+  /** Builds a text report of all slots, listing only the topN most expensive
+      aerodynamic functions.
+      @param topN the number of functions to list
+      @return the report */
+  std::string GetReport(unsigned int topN=10) const;
+
+  /** Writes the trace events of every live profiler to a Chrome trace file
+      that can be loaded in chrome://tracing or ui.perfetto.dev.
+      @param fname the name of the file to write
+      @return true if the file was written */
+  static bool WriteChromeTrace(const std::string& fname);
+
+  double GetCalls(int slot) const    {return (double)Slots[slot].calls;}
+  double GetTotalMs(int slot) const  {return Slots[slot].total*1e-6;}
+  double GetMeanUs(int slot) const;
+  double GetMinUs(int slot) const;
+  double GetMaxUs(int slot) const    {return Slots[slot].max*1e-3;}
+  double GetP50Us(int slot) const    {return GetPercentileUs(slot, 0.50);}
+  double GetP99Us(int slot) const    {return GetPercentileUs(slot, 0.99);}
+
+private:
+  static const unsigned int eNumBuckets = 32;
+
+  struct Slot {
+    eCategory category;
+    std::string name;
+    unsigned long long calls;
+    long long total;
+    long long min;
+    long long max;
+    unsigned long long histogram[eNumBuckets];
+  };
+
+  struct TraceEvent {
+    int slot;
+    unsigned int tid;
+    long long start;
+    long long duration;
+  };
+
+  unsigned int IdFDM;
+  bool enabled;
+  bool tracing;
+  std::vector<Slot> Slots;
+  std::map<std::string, int> SlotIndex;
+  FGPropertyManager* PropertyManager;
+
+  // Guards Trace, and the growth of Slots that WriteChromeTrace() reads.
+  std::mutex TraceLock;
+  std::vector<TraceEvent> Trace;
+  unsigned int TraceCapacity;
+  unsigned int TraceHead;
+
+  static const char* CategoryName(eCategory category);
+  double GetPercentileUs(int slot, double fraction) const;
+  void BindSlot(int slot);
+  void ClearSlot(Slot& s);
+};
+
+/** Times the enclosing scope into a profiler slot.
+    Does nothing when the profiler pointer is null or the profiler is disabled.
+    Use through the FG_PROFILE_SCOPE macro so that it is compiled out when
+    JSBSIM_PROFILING is not defined. */
+class FGProfileTimer
+{
+public:
+  FGProfileTimer(FGProfiler* p, int s)
+    : profiler((p && p->Enabled()) ? p : 0), slot(s), start(0)
+  {
+    if (profiler) start = FGProfiler::Now();
+  }
+  ~FGProfileTimer() {
+    if (profiler) profiler->Record(slot, start, FGProfiler::Now());
+  }
+
+private:
+  FGProfiler* profiler;
+  int slot;
+  long long start;
+
+  FGProfileTimer(const FGProfileTimer&);
+  FGProfileTimer& operator=(const FGProfileTimer&);
+};
+
+} // namespace JSBSim
+
+#endif // JSBSIM_PROFILING
+#endif
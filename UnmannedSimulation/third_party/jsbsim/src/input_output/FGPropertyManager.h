@@ -395,9 +395,8 @@ class FGPropertyManager
     { return root->GetNode(relpath, index, create); }
     bool HasNode(const std::string& path) const
     {
-      std::string newPath = path;
-      if (newPath[0] == '-') newPath.erase(0,1);
-      return root->HasNode(newPath);
+      if (path[0] == '-') return root->HasNode(path.substr(1));
+      return root->HasNode(path);
     }
 
     /** Property-ify a name
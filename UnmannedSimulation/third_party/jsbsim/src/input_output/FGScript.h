@@ -198,6 +198,11 @@ public:
 
   void ResetEvents(void);
 
+  /** Checks whether an event has been triggered and is still to set, or is
+      still ramping, one of its properties.
+      @return true if a triggered event has not completed yet */
+  bool HasPendingEvents(void) const;
+
 private:
   enum eAction {
     FG_RAMP  = 1,
@@ -136,6 +136,13 @@ public:
       @return a string with the delimeter-separated contents of the vector  */
   std::string Dump(const std::string& delimeter) const;
 
+  /** Writes the contents of the vector to a stream.
+      Same format as Dump(delimeter) without building an intermediate string.
+      The precision of the stream is restored afterwards.
+      @param os the stream to write to
+      @param delimeter the item separator (tab or comma) */
+  void Dump(std::ostream& os, const std::string& delimeter) const;
+
   /** Assignment operator.
       @param b source vector.
       Copy the content of the vector given in the argument into *this.   */
@@ -161,6 +161,11 @@ public:
       @return a string with the delimeter-separated contents of the matrix  */
   std::string Dump(const std::string& delimeter) const;
 
+  /** Writes the contents of the matrix to a stream.
+      Same format as Dump(delimeter) without building an intermediate string.
+      The precision of the stream is restored afterwards. */
+  void Dump(std::ostream& os, const std::string& delimeter) const;
+
   /** Prints the contents of the matrix.
       @param delimeter the item separator (tab or comma, etc.)
       @param prefix an additional prefix that is used to indent the 3X3 matrix printout
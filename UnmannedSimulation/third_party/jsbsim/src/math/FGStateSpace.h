@@ -151,9 +151,15 @@ public:
         std::vector<double> get() const
         {
             std::vector<double> val;
-            for (unsigned int i=0;i<getSize();i++) val.push_back(m_components[i]->get());
+            get(val);
             return val;
         }
+        /// fills val in place, reusing its storage
+        void get(std::vector<double> & val) const
+        {
+            val.resize(getSize());
+            for (unsigned int i=0;i<getSize();i++) val[i] = m_components[i]->get();
+        }
         void get(double * array) const
         {
             for (unsigned int i=0;i<getSize();i++) array[i] = m_components[i]->get();
@@ -165,14 +171,20 @@ public:
         std::vector<double> getDeriv() const
         {
             std::vector<double> val;
-            for (unsigned int i=0;i<getSize();i++) val.push_back(m_components[i]->getDeriv());
+            getDeriv(val);
             return val;
         }
+        /// fills val in place, reusing its storage
+        void getDeriv(std::vector<double> & val) const
+        {
+            val.resize(getSize());
+            for (unsigned int i=0;i<getSize();i++) val[i] = m_components[i]->getDeriv();
+        }
         void getDeriv(double * array) const
         {
             for (unsigned int i=0;i<getSize();i++) array[i] = m_components[i]->getDeriv();
         }
-        void set(std::vector<double> vals)
+        void set(const std::vector<double> & vals)
         {
             for (unsigned int i=0;i<getSize();i++) m_components[i]->set(vals[i]);
             m_stateSpace->run();
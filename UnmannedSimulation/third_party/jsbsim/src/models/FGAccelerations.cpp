@@ -260,11 +260,21 @@ void FGAccelerations::ResolveFrictionForces(double dt)
   vFrictionForces.InitMatrix();
   vFrictionMoments.InitMatrix();
 
+  // The work arrays are members sized for every multiplier the ground
+  // reactions model has room for, so that they are allocated on the first
+  // frame rather than when the gears first touch the ground. Only the leading
+  // n*n and n elements are used; each is written below before being read.
+  size_t nmax = multipliers.capacity();
+  if (FrictionRHS.size() < nmax) {
+    FrictionMatrix.resize(nmax*nmax);
+    FrictionRHS.resize(nmax);
+  }
+
   // If no gears are in contact with the ground then return
   if (!n) return;
 
-  vector<double> a(n*n); // Will contain Jac*M^-1*Jac^T
-  vector<double> rhs(n);
+  vector<double>& a = FrictionMatrix; // Will contain Jac*M^-1*Jac^T
+  vector<double>& rhs = FrictionRHS;
 
   // Assemble the linear system of equations
   for (unsigned int i=0; i < n; i++) {
@@ -392,6 +392,8 @@ private:
   FGColumnVector3 vGravAccel;
   FGColumnVector3 vFrictionForces;
   FGColumnVector3 vFrictionMoments;
+  std::vector<double> FrictionMatrix;
+  std::vector<double> FrictionRHS;
 
   int gravType;
   bool gravTorque;
@@ -237,6 +237,10 @@ private:
   FGColumnVector3 vFw;
   FGColumnVector3 vForces;
   AeroFunctionArray* AeroFunctionsAtCG;
+#ifdef JSBSIM_PROFILING
+  std::vector <int> ProfileSlots[6];
+  std::vector <int> ProfileSlotsAtCG[6];
+#endif
   FGColumnVector3 vFwAtCG;
   FGColumnVector3 vFnativeAtCG;
   FGColumnVector3 vForcesAtCG;
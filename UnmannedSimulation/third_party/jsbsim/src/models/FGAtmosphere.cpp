@@ -61,7 +61,8 @@ FGAtmosphere::FGAtmosphere(FGFDMExec* fdmex) : FGModel(fdmex),
                                                PressureAltitude(0.0),      // ft
                                                DensityAltitude(0.0),       // ft
                                                SutherlandConstant(198.72), // deg Rankine
-                                               Beta(2.269690E-08)          // slug/(sec ft R^0.5)
+                                               Beta(2.269690E-08),         // slug/(sec ft R^0.5)
+                                               TableEnvironment(0)
 {
   Name = "FGAtmosphere";
 
@@ -113,21 +114,33 @@ bool FGAtmosphere::Run(bool Holding)
 
 void FGAtmosphere::Calculate(double altitude)
 {
+  // The override nodes are looked up through C strings on every call: going
+  // through std::string paths here would allocate on each frame.
   FGPropertyNode* node = PropertyManager->GetNode();
-  if (!PropertyManager->HasNode("atmosphere/override/temperature"))
-    Temperature = GetTemperature(altitude);
+  const SGPropertyNode* overrideNode;
+
+  const FGEnvironment::AtmosphereTable* table = UpdateTable();
+  bool tabulated = table && table->Covers(altitude);
+  double tableTemperature, tablePressure;
+  if (tabulated) table->Lookup(altitude, tableTemperature, tablePressure);
+
+  overrideNode = node->getNode("atmosphere/override/temperature", false);
+  if (!overrideNode)
+    Temperature = tabulated ? tableTemperature : GetTemperature(altitude);
   else
-    Temperature = node->GetDouble("atmosphere/override/temperature");
+    Temperature = overrideNode->getDoubleValue();
 
-  if (!PropertyManager->HasNode("atmosphere/override/pressure"))
-    Pressure = GetPressure(altitude);
+  overrideNode = node->getNode("atmosphere/override/pressure", false);
+  if (!overrideNode)
+    Pressure = tabulated ? tablePressure : GetPressure(altitude);
   else
-    Pressure = node->GetDouble("atmosphere/override/pressure");
+    Pressure = overrideNode->getDoubleValue();
 
-  if (!PropertyManager->HasNode("atmosphere/override/density"))
+  overrideNode = node->getNode("atmosphere/override/density", false);
+  if (!overrideNode)
     Density = Pressure/(Reng*Temperature);
   else
-    Density = node->GetDouble("atmosphere/override/density");
+    Density = overrideNode->getDoubleValue();
 
   Soundspeed  = sqrt(SHRatio*Reng*(Temperature));
   PressureAltitude = altitude;
@@ -137,6 +150,30 @@ void FGAtmosphere::Calculate(double altitude)
   KinematicViscosity = Viscosity / Density;
 }
 
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// The weather is checked on every call, so that a change made through any
+// setter or property is picked up on the next frame. Only a change of weather
+// reaches into the environment, which takes a lock.
+
+const FGEnvironment::AtmosphereTable* FGAtmosphere::UpdateTable(void)
+{
+  FGEnvironment* env = FDMExec->GetEnvironment();
+  FGEnvironment::WeatherKey weather;
+
+  if (!env || !GetWeatherKey(weather)) {
+    Table.reset();
+    return 0;
+  }
+
+  if (!Table || env != TableEnvironment || weather != TableWeather) {
+    Table = env->GetAtmosphereTable(Name, weather, *this);
+    TableEnvironment = env;
+    TableWeather = weather;
+  }
+
+  return Table.get();
+}
+
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 
 void FGAtmosphere::SetPressureSL(ePressure unit, double pressure)
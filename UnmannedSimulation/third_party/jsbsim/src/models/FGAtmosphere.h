@@ -38,8 +38,10 @@ SENTRY
 INCLUDES
 %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
 
+#include <memory>
 #include <vector>
 #include "models/FGModel.h"
+#include "models/atmosphere/FGEnvironment.h"
 
 /*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 DEFINITIONS
@@ -73,6 +75,11 @@ CLASS DOCUMENTATION
   @property atmosphere/delta
   @property atmosphere/a-ratio
 
+  When the executive has an FGEnvironment attached, the temperature and
+  pressure of models that describe their weather with GetWeatherKey() are
+  interpolated in a table shared with the other FDMs flying in the same
+  weather, instead of being computed on every frame.
+
   @author Jon Berndt
   @version $Id: FGAtmosphere.h,v 1.31 2012/08/20 12:28:50 jberndt Exp $
 */
@@ -211,6 +218,13 @@ public:
 
   virtual double GetPressureAltitude() const {return PressureAltitude;}
 
+  /** Describes the weather the model currently produces, so that FDMs in the
+      same weather can share an altitude table in an FGEnvironment.
+      @param key receives the weather.
+      @return false if the model is not a function of altitude alone, in which
+              case it is always computed directly. */
+  virtual bool GetWeatherKey(FGEnvironment::WeatherKey& /*key*/) const { return false; }
+
   struct Inputs {
     double altitudeASL;
   } in;
@@ -226,9 +240,16 @@ protected:
   const double SutherlandConstant, Beta;
   double Viscosity, KinematicViscosity;
 
+  std::shared_ptr<const FGEnvironment::AtmosphereTable> Table;
+  FGEnvironment* TableEnvironment;
+  FGEnvironment::WeatherKey TableWeather;
+
   /// Calculate the atmosphere for the given altitude.
   void Calculate(double altitude);
 
+  /// Returns the shared table for the current weather, or null if there is none.
+  const FGEnvironment::AtmosphereTable* UpdateTable(void);
+
   // Converts to Rankine from one of several unit systems.
   virtual double ConvertToRankine(double t, eTemperature unit) const;
   
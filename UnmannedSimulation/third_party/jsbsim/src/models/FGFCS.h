@@ -585,6 +585,9 @@ private:
 
   typedef std::vector <FGFCSChannel*> Channels;
   Channels SystemChannels;
+#ifdef JSBSIM_PROFILING
+  std::vector <int> ChannelSlots;
+#endif
   void bind(void);
   void bindModel(void);
   void bindThrottle(unsigned int);
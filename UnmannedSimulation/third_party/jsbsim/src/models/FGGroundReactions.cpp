@@ -160,6 +160,10 @@ bool FGGroundReactions::Load(Element* document)
 
   for (unsigned int i=0; i<lGear.size();i++) lGear[i]->bind();
 
+  // A contact registers at most three Lagrange multipliers per frame (rolling,
+  // side and dynamic friction).
+  multipliers.reserve(3*lGear.size());
+
   PostLoad(document, PropertyManager);
 
   return true;
@@ -42,6 +42,7 @@ INCLUDES
 #include "FGFDMExec.h"
 #include "input_output/FGInputSocket.h"
 #include "input_output/FGUDPInputSocket.h"
+#include "input_output/FGBinarySocket.h"
 #include "input_output/FGXMLFileRead.h"
 #include "input_output/FGXMLElement.h"
 #include "input_output/FGModelLoader.h"
@@ -104,6 +105,8 @@ bool FGInput::Load(Element* el)
     Input = new FGInputSocket(FDMExec);
   } else if (type == "QTJSBSIM") {
     Input = new FGUDPInputSocket(FDMExec);
+  } else if (type == "BINARY") {
+    Input = new FGBinarySocket(FDMExec);
   } else if (type != string("NONE")) {
     cerr << element->ReadFrom()
          << "Unknown type of input specified in config file" << endl;
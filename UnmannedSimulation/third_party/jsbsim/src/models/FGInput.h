@@ -69,6 +69,11 @@ CLASS DOCUMENTATION
       SOCKET      Will eventually send data to a socket input, where NAME
                   would then be the IP address of the machine the data should
                   be sent to. DON'T USE THIS YET!
+      QTJSBSIM    Reads comma separated values from a UDP socket, see
+                  FGUDPInputSocket.
+      BINARY      Serves the binary property session protocol on a TCP or
+                  UDP port, see FGBinarySocket. Clients register properties
+                  once, then set them and subscribe to their changes by ID.
       NONE        Specifies to do nothing. This setting makes it easy to turn on and
                   off the data input without having to mess with anything else.
 
@@ -76,6 +81,7 @@ CLASS DOCUMENTATION
 </pre>
 @code
 <input type="SOCKET" port="4321"/>
+<input type="BINARY" port="5140" protocol="UDP" rate="60"/>
 @endcode
 <br>
 
@@ -267,6 +267,48 @@ bool FGPropagate::Run(bool Holding)
   return false;
 }
 
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// The ECEF location and the ECEF to body transform are left as they are; the
+// inertial position, attitude, velocity and rates are derived from them once
+// the EPA has moved on, in the same order as in Run(). The auxiliary state
+// (terrain velocity, radius and local velocity) is refreshed as well, since
+// the terrain under a parked vehicle may move.
+
+bool FGPropagate::RunAtRest(bool Holding)
+{
+  if (FGModel::Run(Holding)) return true;  // Fast return if we have nothing to do ...
+  if (Holding) return false;
+
+  VState.vLocation.IncrementEarthPositionAngle(in.vOmegaPlanet(eZ)*(in.DeltaT*rate));
+
+  Ti2ec = VState.vLocation.GetTi2ec(); // ECI to ECEF transform
+  Tec2i = Ti2ec.Transposed();          // ECEF to ECI frame transform
+
+  VState.vInertialPosition = Tec2i * VState.vLocation;
+
+  UpdateLocationMatrices();
+
+  // Tec2b still holds the attitude relative to the Earth.
+  VState.qAttitudeECI = (Tec2b * Ti2ec).GetQuaternion();
+  VState.qAttitudeECI.Normalize();
+
+  UpdateBodyMatrices();
+
+  CalculateInertialVelocity();
+
+  RecomputeLocalTerrainVelocity();
+  VehicleRadius = GetRadius();
+
+  VState.vPQRi = VState.vPQR + Ti2b * in.vOmegaPlanet;
+
+  VState.qAttitudeLocal = Tl2b.GetQuaternion();
+
+  vVel = Tb2l * VState.vUVW;
+
+  Debug(2);
+  return false;
+}
+
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
   // Transform the velocity vector of the body relative to the origin (Earth
   // center) to be expressed in the inertial frame, and add the vehicle velocity
@@ -297,8 +339,7 @@ void FGPropagate::Integrate( FGColumnVector3& Integrand,
                              double dt,
                              eIntegrateType integration_type)
 {
-  ValDot.push_front(Val);
-  ValDot.pop_back();
+  ShiftHistory(ValDot, Val);
 
   switch(integration_type) {
   case eRectEuler:       Integrand += dt*ValDot[0];
@@ -332,8 +373,7 @@ void FGPropagate::Integrate( FGQuaternion& Integrand,
                              double dt,
                              eIntegrateType integration_type)
 {
-  ValDot.push_front(Val);
-  ValDot.pop_back();
+  ShiftHistory(ValDot, Val);
 
   switch(integration_type) {
   case eRectEuler:       Integrand += dt*ValDot[0];
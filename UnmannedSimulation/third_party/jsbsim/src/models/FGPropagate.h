@@ -176,6 +176,18 @@ public:
       @return false if no error */
   bool Run(bool Holding);
 
+  /** Runs the state propagation of a vehicle resting on the ground; called by
+      a sleeping executive instead of Run(). The equations of motion are not
+      integrated: the vehicle keeps its location, attitude, velocity and rates
+      relative to the Earth, while the Earth position angle and the inertial
+      state follow the rotation of the planet. The past derivatives used by
+      the integrators are left untouched: InitializeDerivatives() must be
+      called before the vehicle is integrated again.
+      @param Holding if true, the executive has been directed to hold the sim
+                     from advancing time.
+      @return false if no error */
+  bool RunAtRest(bool Holding);
+
   /** Retrieves the velocity vector.
       The vector returned is represented by an FGColumnVector reference. The vector
       for the velocity in Local frame is organized (Vnorth, Veast, Vdown). The vector
@@ -641,6 +653,17 @@ private:
                   double dt,
                   eIntegrateType integration_type);
 
+  /** Pushes a new value at the front of a fixed length history of past
+      derivatives, dropping the oldest one. The values are shifted in place
+      rather than pushed and popped so that the deque never allocates or
+      frees a block during the integration. */
+  template <class T>
+  static void ShiftHistory(std::deque <T>& history, const T& value)
+  {
+    for (size_t i=history.size()-1; i>0; i--) history[i] = history[i-1];
+    history[0] = value;
+  }
+
   void UpdateLocationMatrices(void);
   void UpdateBodyMatrices(void);
   void UpdateVehicleState(void);
@@ -0,0 +1,315 @@
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+ Module:       FGEnvironment.cpp
+ Date started: 10/18/26
+ Purpose:      Atmosphere tables and turbulence field shared between FDMs
+
+ ------------- Copyright (C) 2026 -------------
+
+ This program is free software; you can redistribute it and/or modify it under
+ the terms of the GNU Lesser General Public License as published by the Free Software
+ Foundation; either version 2 of the License, or (at your option) any later
+ version.
+
+ This program is distributed in the hope that it will be useful, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for more
+ details.
+
+ You should have received a copy of the GNU Lesser General Public License along with
+ this program; if not, write to the Free Software Foundation, Inc., 59 Temple
+ Place - Suite 330, Boston, MA  02111-1307, USA.
+
+ Further information about the GNU Lesser General Public License can also be found on
+ the world wide web at http://www.gnu.org.
+
+FUNCTIONAL DESCRIPTION
+--------------------------------------------------------------------------------
+This class holds the environment data that several FGFDMExec instances can
+share: atmosphere tables indexed by altitude and a frozen turbulence field.
+
+HISTORY
+--------------------------------------------------------------------------------
+10/18/26          Created
+
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+INCLUDES
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include "FGEnvironment.h"
+#include "models/FGAtmosphere.h"
+
+using namespace std;
+
+namespace JSBSim {
+
+IDENT(IdSrc,"$Id: FGEnvironment.cpp,v 1.1 2026/10/18 00:00:00 Exp $");
+IDENT(IdHdr,ID_ENVIRONMENT);
+
+/*%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+CLASS IMPLEMENTATION
+%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%*/
+
+// The tables span the altitudes the standard atmosphere is tabulated for, with
+// some room below sea level. Above MaxAltitude the models are called directly.
+const double FGEnvironment::AtmosphereTable::MinAltitude = -2000.0;  // ft
+const double FGEnvironment::AtmosphereTable::MaxAltitude = 300000.0; // ft
+const double FGEnvironment::AtmosphereTable::Step = 100.0;           // ft
+
+// MIL-F-8785C, Sec. 3.7.2.1: scale length above 2000 ft
+const double FGEnvironment::ScaleLength = 1750.0; // ft
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+bool FGEnvironment::WeatherKey::operator==(const WeatherKey& k) const
+{
+  for (int i=0; i<4; i++)
+    if (Value[i] != k.Value[i]) return false;
+  return true;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+bool FGEnvironment::WeatherKey::operator<(const WeatherKey& k) const
+{
+  for (int i=0; i<4; i++) {
+    if (Value[i] < k.Value[i]) return true;
+    if (k.Value[i] < Value[i]) return false;
+  }
+  return false;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+FGEnvironment::AtmosphereTable::AtmosphereTable(const FGAtmosphere& model)
+{
+  unsigned int nodes = (unsigned int)((MaxAltitude - MinAltitude)/Step) + 1;
+
+  Temperature.resize(nodes);
+  LogPressure.resize(nodes);
+
+  for (unsigned int i=0; i<nodes; i++) {
+    double h = MinAltitude + i*Step;
+    Temperature[i] = model.GetTemperature(h);
+    LogPressure[i] = log(model.GetPressure(h));
+  }
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// The temperature is linear in each layer of the standard atmosphere, and the
+// logarithm of the pressure nearly so: both are interpolated linearly.
+
+void FGEnvironment::AtmosphereTable::Lookup(double altitude, double& temperature,
+                                            double& pressure) const
+{
+  double x = (altitude - MinAltitude)/Step;
+  unsigned int i = (unsigned int)x;
+  double f = x - i;
+
+  temperature = Temperature[i] + f*(Temperature[i+1] - Temperature[i]);
+  pressure = exp(LogPressure[i] + f*(LogPressure[i+1] - LogPressure[i]));
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+FGEnvironment::FGEnvironment(unsigned int seed)
+{
+  CellSize = ScaleLength/4.0;
+  rCellSize = 1.0/CellSize;
+
+  GenerateField(seed);
+
+  Debug(0);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+FGEnvironment::~FGEnvironment()
+{
+  Debug(1);
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+FGEnvironment& FGEnvironment::GetShared(void)
+{
+  static FGEnvironment shared;
+  return shared;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Tables are only held weakly here: once no FDM flies in a weather any longer,
+// its table is released.
+
+shared_ptr<const FGEnvironment::AtmosphereTable>
+FGEnvironment::GetAtmosphereTable(const string& name, const WeatherKey& key,
+                                  const FGAtmosphere& model)
+{
+  lock_guard<mutex> lock(TableLock);
+
+  TableId id(name, key);
+  shared_ptr<const AtmosphereTable> table = Tables[id].lock();
+
+  if (!table) {
+    for (auto it = Tables.begin(); it != Tables.end();) {
+      if (it->second.expired()) it = Tables.erase(it);
+      else ++it;
+    }
+
+    table = make_shared<const AtmosphereTable>(model);
+    Tables[id] = table;
+  }
+
+  return table;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Runs a first order filter along one periodic line of the field. A first pass
+// around the line settles the filter state so that the line joins up with
+// itself; the second pass filters in place.
+
+static void FilterLine(float* data, unsigned int length, unsigned int stride,
+                       double a, double b)
+{
+  double y = 0.0;
+
+  for (unsigned int i=0; i<length; i++) y = a*y + b*data[i*stride];
+
+  for (unsigned int i=0; i<length; i++) {
+    y = a*y + b*data[i*stride];
+    data[i*stride] = (float)y;
+  }
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// White noise filtered along each axis by y[k] = a*y[k-1] + sqrt(1-a^2)*x[k]
+// keeps a unit variance and has the correlation a^|k| = exp(-|dx|/L) of the
+// Dryden longitudinal spectrum along each axis.
+
+void FGEnvironment::GenerateField(unsigned int seed)
+{
+  const unsigned int cells = NX*NY*NZ;
+  const double a = exp(-CellSize/ScaleLength);
+  // Trilinear interpolation between correlated nodes lowers the variance away
+  // from the nodes; along each axis it averages 1 - (1-a)/3 over a cell. The
+  // white noise is scaled up so that the sampled field has unit variance.
+  const double b = sqrt(1.0 - a*a) / sqrt(1.0 - (1.0 - a)/3.0);
+
+  mt19937 engine(seed);
+  normal_distribution<double> gauss;
+
+  for (int c=0; c<3; c++) {
+    vector<float>& f = Field[c];
+    f.resize(cells);
+
+    for (unsigned int i=0; i<cells; i++) f[i] = (float)gauss(engine);
+
+    for (unsigned int k=0; k<NZ; k++)
+      for (unsigned int j=0; j<NY; j++)
+        FilterLine(&f[(k*NY + j)*NX], NX, 1, a, b);
+
+    for (unsigned int k=0; k<NZ; k++)
+      for (unsigned int i=0; i<NX; i++)
+        FilterLine(&f[k*NY*NX + i], NY, NX, a, b);
+
+    for (unsigned int j=0; j<NY; j++)
+      for (unsigned int i=0; i<NX; i++)
+        FilterLine(&f[j*NX + i], NZ, NX*NY, a, b);
+  }
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Trilinear interpolation between the cells surrounding each position. The
+// grid dimensions are powers of two, so wrapping an index is a mask.
+
+void FGEnvironment::SampleTurbulence(const FGColumnVector3* positions,
+                                     FGColumnVector3* velocities,
+                                     unsigned int count) const
+{
+  const float* fu = &Field[0][0];
+  const float* fv = &Field[1][0];
+  const float* fw = &Field[2][0];
+
+  for (unsigned int n=0; n<count; n++) {
+    const FGColumnVector3& p = positions[n];
+    double x = p(1)*rCellSize, y = p(2)*rCellSize, z = p(3)*rCellSize;
+    double x0 = floor(x), y0 = floor(y), z0 = floor(z);
+    double tx = x - x0, ty = y - y0, tz = z - z0;
+
+    unsigned int i0 = (unsigned int)(long long)x0 & (NX-1), i1 = (i0+1) & (NX-1);
+    unsigned int j0 = (unsigned int)(long long)y0 & (NY-1), j1 = (j0+1) & (NY-1);
+    unsigned int k0 = (unsigned int)(long long)z0 & (NZ-1), k1 = (k0+1) & (NZ-1);
+
+    unsigned int c[8] = { (k0*NY + j0)*NX + i0, (k0*NY + j0)*NX + i1,
+                          (k0*NY + j1)*NX + i0, (k0*NY + j1)*NX + i1,
+                          (k1*NY + j0)*NX + i0, (k1*NY + j0)*NX + i1,
+                          (k1*NY + j1)*NX + i0, (k1*NY + j1)*NX + i1 };
+    double w[8] = { (1-tx)*(1-ty)*(1-tz), tx*(1-ty)*(1-tz),
+                    (1-tx)*ty*(1-tz),     tx*ty*(1-tz),
+                    (1-tx)*(1-ty)*tz,     tx*(1-ty)*tz,
+                    (1-tx)*ty*tz,         tx*ty*tz };
+
+    double u = 0.0, v = 0.0, ww = 0.0;
+    for (int i=0; i<8; i++) {
+      u  += w[i]*fu[c[i]];
+      v  += w[i]*fv[c[i]];
+      ww += w[i]*fw[c[i]];
+    }
+
+    FGColumnVector3& vel = velocities[n];
+    vel(1) = u;
+    vel(2) = v;
+    vel(3) = ww;
+  }
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+//    The bitmasked value choices are as follows:
+//    unset: In this case (the default) JSBSim would only print
+//       out the normally expected messages, essentially echoing
+//       the config files as they are read. If the environment
+//       variable is not set, debug_lvl is set to 1 internally
+//    0: This requests JSBSim not to output any messages
+//       whatsoever.
+//    1: This value explicity requests the normal JSBSim
+//       startup messages
+//    2: This value asks for a message to be printed out when
+//       a class is instantiated
+//    4: When this value is set, a message is displayed when a
+//       FGModel object executes its Run() method
+//    8: When this value is set, various runtime state variables
+//       are printed out periodically
+//    16: When set various parameters are sanity checked and
+//       a message is printed out when they go out of bounds
+
+void FGEnvironment::Debug(int from)
+{
+  if (debug_lvl <= 0) return;
+
+  if (debug_lvl & 1) { // Standard console startup message output
+    if (from == 0) { // Constructor
+    }
+  }
+  if (debug_lvl & 2 ) { // Instantiation/Destruction notification
+    if (from == 0) cout << "Instantiated: FGEnvironment" << endl;
+    if (from == 1) cout << "Destroyed:    FGEnvironment" << endl;
+  }
+  if (debug_lvl & 4 ) { // Run() method entry print for FGModel-derived objects
+  }
+  if (debug_lvl & 8 ) { // Runtime state variables
+  }
+  if (debug_lvl & 16) { // Sanity checking
+  }
+  if (debug_lvl & 64) {
+    if (from == 0) { // Constructor
+      cout << IdSrc << endl;
+      cout << IdHdr << endl;
+    }
+  }
+}
+
+} // namespace JSBSim
@@ -45,6 +45,7 @@ INCLUDES
 #include <iostream>
 #include <cstdlib>
 #include "FGWinds.h"
+#include "FGEnvironment.h"
 #include "FGFDMExec.h"
 
 using namespace std;
@@ -74,6 +75,50 @@ static inline double square_signed (double value)
 /// simply square a value
 static inline double sqr(double x) { return x*x; }
 
+// This is Figure 7 from p. 49 of MIL-F-8785C: turbulence intensity (ft/s)
+// against altitude (ft) for each probability of exceedence curve. The data is
+// constant and shared by all FGWinds instances.
+static const double POE_Index[7] = { 1, 2, 3, 4, 5, 6, 7 };
+static const double POE_Altitude[12] = {
+  500.0, 1750.0, 3750.0, 7500.0, 15000.0, 25000.0, 35000.0, 45000.0, 55000.0, 65000.0, 75000.0, 80000.0 };
+static const double POE_Sigma[7][12] = {
+  {  3.2,  2.2,  1.5,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0 },
+  {  4.2,  3.6,  3.3,  1.6,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0,  0.0 },
+  {  6.6,  6.9,  7.4,  6.7,  4.6,  2.7,  0.4,  0.0,  0.0,  0.0,  0.0,  0.0 },
+  {  8.6,  9.6, 10.6, 10.1,  8.0,  6.6,  5.0,  4.2,  2.7,  0.0,  0.0,  0.0 },
+  { 11.8, 13.0, 16.0, 15.1, 11.6,  9.7,  8.1,  8.2,  7.9,  4.9,  3.2,  2.1 },
+  { 15.6, 17.6, 23.0, 23.6, 22.1, 20.0, 16.0, 15.1, 12.1,  7.9,  6.2,  5.1 },
+  { 18.7, 21.5, 28.4, 30.2, 30.7, 31.0, 25.2, 23.1, 17.5, 10.7,  8.4,  7.2 } };
+
+// Finds the interval of a breakpoint array that brackets the key and the
+// position of the key within it, clamped to the ends of the array.
+static void Bracket(const double* keys, unsigned int n, double key,
+                    unsigned int& i, double& factor)
+{
+  i = 1;
+  while (i < n-1 && keys[i] < key) i++;
+
+  factor = (key - keys[i-1]) / (keys[i] - keys[i-1]);
+  if (factor > 1.0) factor = 1.0;
+  else if (factor < 0.0) factor = 0.0;
+}
+
+// Interpolates the probability of exceedence table like a 2D FGTable does, but
+// without a lookup hint so that the data can be read from several threads.
+static double ProbabilityOfExceedence(int index, double h)
+{
+  unsigned int r, c;
+  double rFactor, cFactor;
+
+  Bracket(POE_Index, 7, index, r, rFactor);
+  Bracket(POE_Altitude, 12, h, c, cFactor);
+
+  double col1 = rFactor*(POE_Sigma[r][c-1] - POE_Sigma[r-1][c-1]) + POE_Sigma[r-1][c-1];
+  double col2 = rFactor*(POE_Sigma[r][c] - POE_Sigma[r-1][c]) + POE_Sigma[r-1][c];
+
+  return col1 + cFactor*(col2 - col1);
+}
+
 FGWinds::FGWinds(FGFDMExec* fdmex) : FGModel(fdmex)
 {
   Name = "FGWinds";
@@ -94,18 +139,7 @@ FGWinds::FGWinds(FGFDMExec* fdmex) : FGModel(fdmex)
   // Milspec turbulence model
   windspeed_at_20ft = 0.;
   probability_of_exceedence_index = 0;
-  POE_Table = new FGTable(7,12);
-  // this is Figure 7 from p. 49 of MIL-F-8785C
-  // rows: probability of exceedance curve index, cols: altitude in ft
-  *POE_Table
-           << 500.0 << 1750.0 << 3750.0 << 7500.0 << 15000.0 << 25000.0 << 35000.0 << 45000.0 << 55000.0 << 65000.0 << 75000.0 << 80000.0
-    << 1   <<   3.2 <<    2.2 <<    1.5 <<    0.0 <<     0.0 <<     0.0 <<     0.0 <<     0.0 <<     0.0 <<     0.0 <<     0.0 <<     0.0
-    << 2   <<   4.2 <<    3.6 <<    3.3 <<    1.6 <<     0.0 <<     0.0 <<     0.0 <<     0.0 <<     0.0 <<     0.0 <<     0.0 <<     0.0
-    << 3   <<   6.6 <<    6.9 <<    7.4 <<    6.7 <<     4.6 <<     2.7 <<     0.4 <<     0.0 <<     0.0 <<     0.0 <<     0.0 <<     0.0
-    << 4   <<   8.6 <<    9.6 <<   10.6 <<   10.1 <<     8.0 <<     6.6 <<     5.0 <<     4.2 <<     2.7 <<     0.0 <<     0.0 <<     0.0
-    << 5   <<  11.8 <<   13.0 <<   16.0 <<   15.1 <<    11.6 <<     9.7 <<     8.1 <<     8.2 <<     7.9 <<     4.9 <<     3.2 <<     2.1
-    << 6   <<  15.6 <<   17.6 <<   23.0 <<   23.6 <<    22.1 <<    20.0 <<    16.0 <<    15.1 <<    12.1 <<     7.9 <<     6.2 <<     5.1
-    << 7   <<  18.7 <<   21.5 <<   28.4 <<   30.2 <<    30.7 <<    31.0 <<    25.2 <<    23.1 <<    17.5 <<    10.7 <<     8.4 <<     7.2;
+  ResetDrydenFilters();
 
   bind();
   Debug(0);
@@ -115,7 +149,6 @@ FGWinds::FGWinds(FGFDMExec* fdmex) : FGModel(fdmex)
 
 FGWinds::~FGWinds()
 {
-  delete(POE_Table);
   Debug(1);
 }
 
@@ -134,6 +167,8 @@ bool FGWinds::InitModel(void)
   oneMinusCosineGust.gustProfile.Running = false;
   oneMinusCosineGust.gustProfile.elapsedTime = 0.0;
 
+  ResetDrydenFilters();
+
   return true;
 }
 
@@ -265,30 +300,7 @@ void FGWinds::Turbulence(double h)
     // clip height functions at 10 ft
     if (h <= 10.) h = 10;
 
-    // Scale lengths L and amplitudes sigma as function of height
-    if (h <= 1000) {
-      L_u = h/pow(0.177 + 0.000823*h, 1.2); // MIL-F-8785c, Fig. 10, p. 55
-      L_w = h;
-      sig_w = 0.1*windspeed_at_20ft;
-      sig_u = sig_w/pow(0.177 + 0.000823*h, 0.4); // MIL-F-8785c, Fig. 11, p. 56
-    } else if (h <= 2000) {
-      // linear interpolation between low altitude and high altitude models
-      L_u = L_w = 1000 + (h-1000.)/1000.*750.;
-      sig_u = sig_w = 0.1*windspeed_at_20ft
-                    + (h-1000.)/1000.*(POE_Table->GetValue(probability_of_exceedence_index, h) - 0.1*windspeed_at_20ft);
-    } else {
-      L_u = L_w = 1750.; //  MIL-F-8785c, Sec. 3.7.2.1, p. 48
-      sig_u = sig_w = POE_Table->GetValue(probability_of_exceedence_index, h);
-    }
-
-    // keep values from last timesteps
-    // TODO maybe use deque?
-    static double
-      xi_u_km1 = 0, nu_u_km1 = 0,
-      xi_v_km1 = 0, xi_v_km2 = 0, nu_v_km1 = 0, nu_v_km2 = 0,
-      xi_w_km1 = 0, xi_w_km2 = 0, nu_w_km1 = 0, nu_w_km2 = 0,
-      xi_p_km1 = 0, nu_p_km1 = 0,
-      xi_q_km1 = 0, xi_r_km1 = 0;
+    MilspecIntensities(h, L_u, L_w, sig_u, sig_w);
 
 
     double
@@ -377,7 +389,11 @@ void FGWinds::Turbulence(double h)
     xi_q_km1 = xi_q;
     xi_r_km1 = xi_r;
 
+    break;
   }
+  case ttField:
+    FieldTurbulence(h);
+    break;
   default:
     break;
   }
@@ -386,6 +402,95 @@ void FGWinds::Turbulence(double h)
 
 }
 
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Scale lengths L and amplitudes sigma as function of height
+
+void FGWinds::MilspecIntensities(double h, double& L_u, double& L_w,
+                                 double& sig_u, double& sig_w) const
+{
+  if (h <= 1000) {
+    L_u = h/pow(0.177 + 0.000823*h, 1.2); // MIL-F-8785c, Fig. 10, p. 55
+    L_w = h;
+    sig_w = 0.1*windspeed_at_20ft;
+    sig_u = sig_w/pow(0.177 + 0.000823*h, 0.4); // MIL-F-8785c, Fig. 11, p. 56
+  } else if (h <= 2000) {
+    // linear interpolation between low altitude and high altitude models
+    L_u = L_w = 1000 + (h-1000.)/1000.*750.;
+    sig_u = sig_w = 0.1*windspeed_at_20ft
+                  + (h-1000.)/1000.*(ProbabilityOfExceedence(probability_of_exceedence_index, h) - 0.1*windspeed_at_20ft);
+  } else {
+    L_u = L_w = 1750.; //  MIL-F-8785c, Sec. 3.7.2.1, p. 48
+    sig_u = sig_w = ProbabilityOfExceedence(probability_of_exceedence_index, h);
+  }
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+
+void FGWinds::ResetDrydenFilters(void)
+{
+  xi_u_km1 = nu_u_km1 = 0.0;
+  xi_v_km1 = xi_v_km2 = nu_v_km1 = nu_v_km2 = 0.0;
+  xi_w_km1 = xi_w_km2 = nu_w_km1 = nu_w_km2 = 0.0;
+  xi_p_km1 = nu_p_km1 = 0.0;
+  xi_q_km1 = xi_r_km1 = 0.0;
+}
+
+//%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+// Samples the shared turbulence field at the center of the aircraft and at the
+// ends of its body x and y axes, one wingspan apart. The field is frozen and
+// drifts with the mean wind (Taylor's hypothesis), so the gusts met by the
+// aircraft only depend on where it flies.
+
+void FGWinds::FieldTurbulence(double h)
+{
+  // an index of zero means turbulence is disabled
+  if (probability_of_exceedence_index == 0) {
+    vTurbulenceNED(eNorth) = vTurbulenceNED(eEast) = vTurbulenceNED(eDown) = 0.0;
+    vTurbPQR(eP) = vTurbPQR(eQ) = vTurbPQR(eR) = 0.0;
+    return;
+  }
+
+  double b_w = in.wingspan, L_u, L_w, sig_u, sig_w;
+
+  if (b_w == 0.) b_w = 30.;
+
+  // clip height functions at 10 ft
+  if (h <= 10.) h = 10;
+
+  MilspecIntensities(h, L_u, L_w, sig_u, sig_w);
+
+  FGEnvironment* env = FDMExec->GetEnvironment();
+  if (!env) env = &FGEnvironment::GetShared();
+
+  FGColumnVector3 center = in.vLocation - in.Tl2ec*vWindNED*FDMExec->GetSimTime();
+  FGColumnVector3 dx = in.Tl2ec*FGColumnVector3(in.Tl2b(1,1), in.Tl2b(1,2), in.Tl2b(1,3))*(0.5*b_w);
+  FGColumnVector3 dy = in.Tl2ec*FGColumnVector3(in.Tl2b(2,1), in.Tl2b(2,2), in.Tl2b(2,3))*(0.5*b_w);
+
+  FieldPositions[0] = center;
+  FieldPositions[1] = center + dx;
+  FieldPositions[2] = center - dx;
+  FieldPositions[3] = center + dy;
+  FieldPositions[4] = center - dy;
+
+  env->SampleTurbulence(FieldPositions, FieldGusts, 5);
+
+  for (int i=0; i<5; i++) {
+    FieldGusts[i](eNorth) *= sig_u;
+    FieldGusts[i](eEast)  *= sig_u;
+    FieldGusts[i](eDown)  *= sig_w;
+  }
+
+  vTurbulenceNED = FieldGusts[0];
+
+  // Rotary gusts in the body frame: p = dw/dy, q = dw/dx, r = -dv/dx
+  FGColumnVector3 dVdx = in.Tl2b*(FieldGusts[1] - FieldGusts[2])/b_w;
+  FGColumnVector3 dVdy = in.Tl2b*(FieldGusts[3] - FieldGusts[4])/b_w;
+
+  vTurbPQR(eP) =  dVdy(eZ);
+  vTurbPQR(eQ) =  dVdx(eZ);
+  vTurbPQR(eR) = -dVdx(eY);
+}
+
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 
 double FGWinds::CosineGustProfile(double startDuration, double steadyDuration, double endDuration, double elapsedTime)